@@ -0,0 +1,193 @@
+/*
+Configuration footprint and isr cycle benchmark (ATmega328p / ATmega32u4)
+
+Reports what the wwvb configuration costs as csv lines (section,key,value...) :
+config,<define>,<value>                       : the configuration this was built with
+size,<item>,<bytes>                           : sizeof(wwvb), flash and static sram of the whole sketch
+isr,<path>,<calls>,<min>,<mean>,<max>         : cycles per interrupt_routine() path
+isr,<path>,overflow                           : a call took more than 65535 cycles
+
+isr paths
+* tick   : counting carrier periods (almost every call)
+* edge   : the carrier goes high
+* bit    : the start of a bit (set_lowTime, add_time)
+* minute : the start of a frame (the next minute is worked out)
+* day    : the start of a frame on a new day (daylight savings, DUT1, leap second)
+
+The isr isnt started : Timer1 is used as a cycle counter (prescaler 1) and interrupt_routine() is called
+directly, with interrupts off, for a simulated 23:59 -> 00:01 (2 minutes, ~7.2 million calls at 16MHz).
+The run takes a few minutes, define WWVB_TIMEWARP for a faster run (the isr paths are the same).
+
+On the target, a configuration is measured by changing the defines below and re-building, e.g.
+USE_OC1A / USE_OC1B, WWVB_PAM, WWVB_MODULATION_OUT, WWVB_PM, _DEBUG 0 / 1 / 2, and an 8MHz board,
+and the per function code size comes from the build output, e.g. avr-nm --size-sort -C -S benchmark.ino.elf
+The host build (extras/benchmark) builds every combination of these defines and writes sizeof(wwvb),
+the per function code size (host, and avr-g++ if installed) and the isr path host cycles as one csv table:
+cmake -S . -B build && cmake --build build --target config_matrix_table  ->  build/config_matrix.csv
+*/
+
+#include <Arduino.h>
+
+// Configuration
+#define _DEBUG 0
+//#define USE_OC1B
+//#define WWVB_PAM
+//#define WWVB_MODULATION_OUT
+//#define WWVB_PM
+//#define WWVB_TIMEWARP 100
+#define REQUIRE_TIMEDATESTRING 0
+
+#if defined(__AVR_ATtiny25__) | defined(__AVR_ATtiny45__) | defined(__AVR_ATtiny85__)
+#pragma message("ERROR : the benchmark needs the 16 bit Timer1 of the ATmega328p / ATmega32u4")
+#endif
+
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+wwvb wwvb_tx;
+
+// linker symbols (avr-libc)
+extern char __data_start, __data_load_end, __bss_end;
+
+#define PATHS 5
+const char *path_name[PATHS] = { "tick", "edge", "bit", "minute", "day" };
+uint32_t path_calls[PATHS];
+uint32_t path_cycles[PATHS];
+uint16_t path_min[PATHS];
+uint16_t path_max[PATHS];
+bool path_overflow[PATHS];
+
+uint16_t overhead = 0;
+
+// cycles of one interrupt_routine() call, less the measurement overhead (never below 0)
+uint16_t measure(bool &_overflow, const bool _empty = false)
+{
+	uint8_t _sreg = SREG;
+	cli();
+	TIFR1 = _BV(TOV1);
+	TCNT1 = 0;
+	if (!_empty)
+	{
+		wwvb_tx.interrupt_routine();
+	}
+	const uint16_t _cycles = TCNT1;
+	_overflow = TIFR1 & _BV(TOV1);
+	SREG = _sreg;
+	return (_cycles > overhead) ? _cycles - overhead : 0;
+}
+
+void print_config(const __FlashStringHelper *_name, const int32_t &_value)
+{
+	Serial.print(F("config,"));
+	Serial.print(_name);
+	Serial.print(',');
+	Serial.println(_value);
+}
+
+void setup()
+{
+	Serial.begin(9600);
+#if defined(__AVR_ATmega16U4__) | defined(__AVR_ATmega32U4__)
+	while (!Serial); // If using a leonardo/micro, wait for the Serial connection
+#endif
+
+	print_config(F("F_CPU"), F_CPU);
+#if defined(USE_OC1A)
+	print_config(F("USE_OC1A"), 1);
+#endif
+#if defined(USE_OC1B)
+	print_config(F("USE_OC1B"), 1);
+#endif
+#if defined(WWVB_PAM)
+	print_config(F("WWVB_PAM"), 1);
+#endif
+#if defined(WWVB_MODULATION_OUT)
+	print_config(F("WWVB_MODULATION_OUT"), 1);
+#endif
+#if defined(WWVB_PM)
+	print_config(F("WWVB_PM"), 1);
+#endif
+	print_config(F("_DEBUG"), _DEBUG);
+	print_config(F("WWVB_TIMEWARP"), WWVB_TIMEWARP);
+
+	Serial.print(F("size,sizeof_wwvb,"));
+	Serial.println(sizeof(wwvb));
+	Serial.print(F("size,flash_bytes,"));
+	Serial.println((uint16_t)&__data_load_end);
+	Serial.print(F("size,sram_static_bytes,"));
+	Serial.println((uint16_t)(&__bss_end - &__data_start));
+
+	wwvb_tx.setup();
+	wwvb_tx.set_time(23, 59, 31, 12, 16);
+
+	// Timer1 as a cycle counter : normal mode, no outputs, no interrupt, prescaler 1
+	TIMSK1 = 0;
+	TCCR1A = 0;
+	TCCR1B = _BV(CS10);
+
+	bool _overflow;
+	overhead = 0;
+	overhead = measure(_overflow, true);
+
+	for (uint8_t p = 0; p < PATHS; ++p)
+	{
+		path_calls[p] = 0;
+		path_cycles[p] = 0;
+		path_min[p] = 0xFFFF;
+		path_max[p] = 0;
+		path_overflow[p] = false;
+	}
+
+	// 2 frames : 23:59 and 00:00 (the first bit of the 00:01 frame ends it)
+	uint8_t _frames = 0;
+	while (_frames < 2)
+	{
+		const uint8_t _frame_index = wwvb_tx.frame_index;
+		const uint8_t _DD = wwvb_tx.DD();
+		const bool _led = digitalRead(LED_BUILTIN); // the isr sets the LED high on the edge, low at the start of a bit
+		const uint16_t _cycles = measure(_overflow);
+
+		uint8_t p = 0; // tick
+		if (wwvb_tx.frame_index != _frame_index)
+		{
+			p = 2; // bit
+			if (wwvb_tx.frame_index == 0)
+			{
+				p = (wwvb_tx.DD() != _DD) ? 4 : 3; // day, minute
+				++_frames;
+			}
+		}
+		else if (!_led && digitalRead(LED_BUILTIN))
+		{
+			p = 1; // edge
+		}
+
+		++path_calls[p];
+		path_cycles[p] += _cycles;
+		if (_cycles < path_min[p]) { path_min[p] = _cycles; }
+		if (_cycles > path_max[p]) { path_max[p] = _cycles; }
+		path_overflow[p] |= _overflow;
+	}
+
+	for (uint8_t p = 0; p < PATHS; ++p)
+	{
+		Serial.print(F("isr,"));
+		Serial.print(path_name[p]);
+		if (path_overflow[p])
+		{
+			Serial.println(F(",overflow"));
+			continue;
+		}
+		Serial.print(',');
+		Serial.print(path_calls[p]);
+		Serial.print(',');
+		Serial.print(path_calls[p] ? path_min[p] : 0);
+		Serial.print(',');
+		Serial.print(path_calls[p] ? path_cycles[p] / path_calls[p] : 0);
+		Serial.print(',');
+		Serial.println(path_max[p]);
+	}
+}
+
+void loop()
+{
+}
@@ -0,0 +1,63 @@
+/*
+Two wwvb clocks showing different timezones from one ATmega328p / ATmega32u4 (16MHz)
+
+Channel 0 : D9  (OC1A) => WWVB ANTENNA 0
+Channel 1 : D10 (OC1B) => WWVB ANTENNA 1
+
+Both antennas share the Timer1 carrier (see wwvb_dual.h). The bit timing (calibrate),
+frames, timezones and daylight savings rules of each channel are independent.
+
+Both clocks have their timezone set to CST (UTC -6:00). Channel 1 is sent a time 2 hours behind,
+so its clock shows PST (UTC -8:00) - and it uses no daylight savings (wwvb_dst_none)
+*/
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+
+#define _DEBUG 0
+#define REQUIRE_TIMEDATESTRING 1
+
+#include <TimeDateTools.h> // include before wwvb_dual.h
+#include <wwvb_dual.h>
+wwvb_dual wwvb_tx;
+
+// The ISR sets the PWM pulse width of both channels
+ISR(TIMER1_OVF_vect)
+{
+	wwvb_tx.interrupt_routine();
+}
+
+// Setup your timezones here
+const int8_t wwvb_timezone[2] = { -6, 0 }; // This is the timezone of your wwvb clocks (and __TIME__) : CST (UTC -6:00)
+const int8_t channel_offset[2][2] = { { 0, 0 }, { -2, 0 } }; // Time shift of each channel
+
+void setup()
+{
+	for (uint8_t c = 0; c < 2; ++c)
+	{
+		// set the timezone to your wwvb timezone (the negative is supposed to be here), plus the channel shift
+		wwvb_tx.channel[c].setTimezone(channel_offset[c][0] - wwvb_timezone[0], channel_offset[c][1] - wwvb_timezone[1]);
+	}
+	wwvb_tx.channel[1].setDSTRule(wwvb_dst_none);
+
+	wwvb_tx.setup();
+	wwvb_tx.set_time(__DATE__, __TIME__, WWVB_DST_AUTO);
+
+	Serial.begin(9600);
+	for (uint8_t c = 0; c < 2; ++c)
+	{
+		Serial.print(F("channel "));
+		Serial.print(c);
+		Serial.print(F(" dst "));
+		Serial.print(wwvb_tx.channel[c].getDST());
+		Serial.print(F(" : "));
+		wwvb_tx.channel[c].print();
+	}
+
+	wwvb_tx.start(); // Thats it
+}
+
+void loop()
+{
+	// Debug LED : follows channel 0 (see wwvb_dual::interrupt_routine)
+}
@@ -360,8 +360,8 @@ void loop()
 		ttl.stopListening();
 		disableSoftwareSerialRead(); // disable SoftwareSerial pin change interrupts
 
-		// Yeah im ignoring the last parameter to set whether we are in daylight savings time
-		wwvb_tx.set_time(gps.hh, gps.mm, gps.DD, gps.MM, gps.YY);
+		// daylight savings is left to the rule (US by default, see wwvb::setDSTRule)
+		wwvb_tx.set_time(gps.hh, gps.mm, gps.DD, gps.MM, gps.YY, WWVB_DST_AUTO);
 		wwvb_tx.start();
 #if (_DEBUG > 0)
 		Serial.println("Start wwvb");
@@ -394,4 +394,4 @@ void loop()
 		t0 = millis();
 		updateDisplay();
 	}
-}
+}
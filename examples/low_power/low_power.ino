@@ -0,0 +1,98 @@
+/*
+Low power wwvb transmitter
+
+The carrier is generated by Timer1 in hardware, so the MCU only needs to be awake for the
+Timer1 isr. loop() idles (SLEEP_MODE_IDLE) until the next interrupt instead of busy-polling millis(),
+and the application work (the LED, serial output) is only done at the start of each bit.
+
+Once a minute the sleep counters are printed as a csv line:
+mm,asleep_ticks,awake_ticks,asleep_percent,estimated_uA
+
+The current estimate uses typical datasheet figures for the ATmega328p at 16MHz / 5V,
+change ACTIVE_uA and IDLE_uA for your board (and measure it!)
+
+Note: millis() (Timer0) also wakes the MCU every 1ms. For the lowest current turn off the
+      peripherals you dont need (ADC, TWI, SPI) with the avr/power.h functions
+*/
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+
+#define _DEBUG 0
+#define REQUIRE_TIMEDATESTRING 1
+#if !defined(WWVB_LOW_POWER)
+#define WWVB_LOW_POWER
+#endif
+
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+wwvb wwvb_tx;
+
+#define ACTIVE_uA 9000
+#define IDLE_uA 2500
+
+// The ISR sets the PWM pulse width to correspond with the WWVB bit
+ISR(TIMER1_OVF_vect)
+{
+	wwvb_tx.interrupt_routine();
+}
+
+const int8_t wwvb_timezone[2] = { -6, 0 }; // This is the timezone of your wwvb clock : CST (UTC -6:00)
+
+uint8_t frame_index = 0;
+uint8_t mins = 0;
+
+void setup()
+{
+	wwvb_tx.setup();
+	wwvb_tx.setTimezone(-wwvb_timezone[0], -wwvb_timezone[1]);
+	wwvb_tx.set_time(__DATE__, __TIME__);
+
+	Serial.begin(9600);
+	Serial.println(F("mm,asleep_ticks,awake_ticks,asleep_percent,estimated_uA"));
+	Serial.flush();
+
+	pinMode(LED_BUILTIN, OUTPUT);
+	mins = wwvb_tx.mm();
+
+	wwvb_tx.reset_power();
+	wwvb_tx.start();
+}
+
+void loop()
+{
+	// sleep until the next interrupt (the wwvb isr, millis or serial)
+	wwvb_tx.idle();
+
+	// nothing to do until the isr starts the next bit
+	if (frame_index == wwvb_tx.frame_index)
+	{
+		return;
+	}
+	frame_index = wwvb_tx.frame_index;
+
+	// the LED follows the seconds
+	digitalWrite(LED_BUILTIN, frame_index & 0x01);
+
+	if (mins != wwvb_tx.mm())
+	{
+		mins = wwvb_tx.mm();
+
+		uint32_t asleep, awake;
+		wwvb_tx.get_power(asleep, awake);
+		const uint32_t ticks = asleep + awake;
+
+		Serial.print(mins);
+		Serial.print(',');
+		Serial.print(asleep);
+		Serial.print(',');
+		Serial.print(awake);
+		Serial.print(',');
+		// percent asleep : the counts are reset every minute (~3.6M ticks), so 100 * asleep fits in 32 bits
+		Serial.print(ticks ? (100UL * asleep) / ticks : 0);
+		Serial.print(',');
+		Serial.println(wwvb_tx.power_estimate(ACTIVE_uA, IDLE_uA));
+
+		wwvb_tx.reset_power();
+	}
+}
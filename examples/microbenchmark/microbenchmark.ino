@@ -0,0 +1,181 @@
+/*
+Microbenchmarks of the encoder and calendar hot paths (ATmega328p / ATmega32u4)
+
+Each benchmark is called BENCH_CALLS times, and each call is timed with Timer1 as a cycle counter
+(prescaler 1, interrupts off), less the cost of calling an empty benchmark.
+The results are csv lines, one per benchmark, in a fixed order so runs can be diffed before / after a change:
+
+name,calls,cycles_per_call,ns_per_call,calls_per_s
+
+benchmarks
+* set_time                          : set_time() of a new minute. set_time always works out daylight savings, DUT1
+                                      and the leap second again, so this is the whole set_time, not one field
+* add_time_secs                     : add_time(0, 0, 1), only the second changes (the minute every 60th call)
+* add_time_mins                     : add_time(0, 1), the minute field is re-encoded (and the hour every 60th call)
+* add_time_hour                     : add_time(1, 0), the hour field is re-encoded (and the day, daylight savings,
+                                      DUT1 and the leap second every 24th call)
+* start                             : set_lowTime() (and resume), the start of a bit
+* symbol                            : symbol() of one bit
+* frame                             : frame(), the whole frame packed into a uint64_t
+* to_day_of_the_year, addTimezone   : TimeDateTools.h, as used by set_time() / add_time()
+* isr_minute                        : interrupt_routine() for a whole simulated minute (per isr call)
+
+The add_time benchmarks are the per field cost : the set_* encoders are only called when their field changes.
+
+Note: it also builds on the host (extras/host, target sketch_microbenchmark), but the host Timer1 isnt a cycle counter
+(every benchmark reports overflow there), so the numbers are from the target. The host isr cycles are in extras/benchmark (config_matrix)
+*/
+
+#include <Arduino.h>
+
+#define _DEBUG 0
+#define REQUIRE_TIMEDATESTRING 0
+
+#if defined(__AVR_ATtiny25__) | defined(__AVR_ATtiny45__) | defined(__AVR_ATtiny85__)
+#pragma message("ERROR : the microbenchmarks need the 16 bit Timer1 of the ATmega328p / ATmega32u4")
+#endif
+
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+wwvb wwvb_tx;
+
+#define BENCH_CALLS 256
+
+typedef void (*bench_fn)(const uint16_t &i);
+
+volatile uint8_t sink; // keeps the results of the benchmarks
+
+void bench_empty(const uint16_t &i) { (void)i; }
+void bench_set_time(const uint16_t &i) { wwvb_tx.set_time(12, i % 60, 15, 6, 16); }
+void bench_add_time_secs(const uint16_t &i) { (void)i; wwvb_tx.add_time(0, 0, 1); }
+void bench_add_time_mins(const uint16_t &i) { (void)i; wwvb_tx.add_time(0, 1); }
+void bench_add_time_hour(const uint16_t &i) { (void)i; wwvb_tx.add_time(1, 0); }
+void bench_isr(const uint16_t &i) { (void)i; wwvb_tx.interrupt_routine(); }
+void bench_start(const uint16_t &i) { (void)i; wwvb_tx.start(); }
+void bench_symbol(const uint16_t &i) { sink = wwvb_tx.symbol(i % 60); }
+void bench_frame(const uint16_t &i) { (void)i; sink = wwvb_tx.frame() & 0xFF; }
+void bench_to_day_of_the_year(const uint16_t &i)
+{
+	sink = to_day_of_the_year<uint8_t>(1 + (i % 28), 1 + (i % 12), (i & 0x03) == 0) & 0xFF;
+}
+void bench_addTimezone(const uint16_t &i)
+{
+	uint8_t _hh = i % 24, _mm = 30, _ss = 0, _DD = 31, _MM = 12, _YY = 16;
+	addTimezone<uint8_t>(_hh, _mm, _ss, _DD, _MM, _YY, -6, 0, 0);
+	sink = _hh;
+}
+
+// cycles of _fn(_i), 0xFFFF if it took more than 65535 cycles
+uint16_t measure(bench_fn _fn, const uint16_t &_i)
+{
+	uint8_t _sreg = SREG;
+	cli();
+	TIFR1 = _BV(TOV1);
+	TCNT1 = 0;
+	_fn(_i);
+	uint16_t _cycles = TCNT1;
+	if (TIFR1 & _BV(TOV1))
+	{
+		_cycles = 0xFFFF;
+	}
+	SREG = _sreg;
+	return _cycles;
+}
+
+uint16_t overhead = 0;
+
+// Timer1 as a cycle counter : normal mode, no outputs, no interrupt, prescaler 1
+// (start() sets Timer1 up for the carrier and its overflow interrupt, so this is done again after it)
+void cycle_counter()
+{
+	TIMSK1 = 0;
+	TCCR1A = 0;
+	TCCR1B = _BV(CS10);
+}
+
+void report(const __FlashStringHelper *_name, const uint32_t &_calls, const uint32_t &_cycles)
+{
+	const uint32_t _cycles_per_call = (_cycles + _calls / 2) / _calls;
+	Serial.print(_name);
+	Serial.print(',');
+	Serial.print(_calls);
+	Serial.print(',');
+	Serial.print(_cycles_per_call);
+	Serial.print(',');
+	Serial.print((_cycles_per_call * 1000UL) / (F_CPU / 1000000UL)); // ns
+	Serial.print(',');
+	Serial.println(_cycles_per_call ? F_CPU / _cycles_per_call : 0); // calls per second
+}
+
+void bench(const __FlashStringHelper *_name, bench_fn _fn)
+{
+	uint32_t _cycles = 0;
+	for (uint16_t i = 0; i < BENCH_CALLS; ++i)
+	{
+		const uint16_t _c = measure(_fn, i);
+		if (_c == 0xFFFF)
+		{
+			Serial.print(_name);
+			Serial.println(F(",overflow"));
+			return;
+		}
+		_cycles += (_c > overhead) ? _c - overhead : 0;
+	}
+	report(_name, BENCH_CALLS, _cycles);
+}
+
+// a whole simulated minute of the isr, one frame : until the first bit of the next frame
+void bench_isr_minute()
+{
+	wwvb_tx.set_time(12, 30, 15, 6, 16);
+	wwvb_tx.start();
+	cycle_counter();
+
+	uint32_t _calls = 0, _cycles = 0;
+	uint8_t _frame_index;
+	do
+	{
+		_frame_index = wwvb_tx.frame_index;
+		const uint16_t _c = measure(bench_isr, 0);
+		if (_c == 0xFFFF)
+		{
+			Serial.println(F("isr_minute,overflow"));
+			return;
+		}
+		_cycles += (_c > overhead) ? _c - overhead : 0;
+		++_calls;
+	} while ((_frame_index == 0) | (wwvb_tx.frame_index != 0));
+	report(F("isr_minute"), _calls, _cycles);
+}
+
+void setup()
+{
+	Serial.begin(9600);
+#if defined(__AVR_ATmega16U4__) | defined(__AVR_ATmega32U4__)
+	while (!Serial); // If using a leonardo/micro, wait for the Serial connection
+#endif
+
+	wwvb_tx.setup();
+	wwvb_tx.set_time(12, 30, 15, 6, 16);
+
+	cycle_counter();
+	overhead = measure(bench_empty, 0);
+
+	Serial.println(F("name,calls,cycles_per_call,ns_per_call,calls_per_s"));
+	bench(F("set_time"), bench_set_time);
+	bench(F("add_time_secs"), bench_add_time_secs);
+	bench(F("add_time_mins"), bench_add_time_mins);
+	bench(F("add_time_hour"), bench_add_time_hour);
+	bench(F("start"), bench_start);
+	cycle_counter();
+	bench(F("symbol"), bench_symbol);
+	bench(F("frame"), bench_frame);
+	bench(F("to_day_of_the_year"), bench_to_day_of_the_year);
+	bench(F("addTimezone"), bench_addTimezone);
+
+	bench_isr_minute();
+}
+
+void loop()
+{
+}
@@ -0,0 +1,108 @@
+/*
+Offline receiver model sweep
+
+Runs the wwvb frame/bit timing through the consumer receiver models in wwvb_receiver.h
+for a sweep of carrier frequencies (ICR1), PWM_LOW values and calibrate() values.
+Each setting is applied to wwvb_tx (setPWM_HIGH, setPWM_LOW, calibrate) and the modulation depth
+is worked out from the PWM_HIGH / PWM_LOW it then has, PWM_HIGH being ~50% of ICR1 as in wwvb::setup().
+Nothing is transmitted (Timer1 is not started), so this runs in a few seconds
+on the ATmega328p / ATmega32u4 instead of waiting minutes per setting on a real clock.
+
+Output is one csv line per setting:
+model,ICR1,carrier_Hz,PWM_LOW,depth_dB,calibrate,locked,time_to_lock_s
+
+Note: assumes a 16MHz clock (isr tick = 2*ICR1 / 16MHz)
+*/
+
+#include <Arduino.h>
+
+#define _DEBUG 0
+#define REQUIRE_TIMEDATESTRING 0
+
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+#include <wwvb_receiver.h>
+
+wwvb wwvb_tx;
+
+#define FRAMES_PER_RUN 5
+
+const char *model_name[3] = { "lenient", "typical", "strict" };
+const wwvb_receiver_model *model[3] = { &WWVB_RX_LENIENT, &WWVB_RX_TYPICAL, &WWVB_RX_STRICT };
+
+const uint16_t sweep_ICR1[3] = { 132, 133, 134 };
+const uint8_t sweep_PWM_LOW[5] = { 0, 3, 6, 12, 24 };
+const int16_t sweep_calibrate[5] = { -1500, -6, 0, 86, 1500 }; // 1500 ticks ~ 25ms
+
+void run(const uint8_t &m, const uint16_t &_ICR1, const uint8_t &_PWM_LOW, const int16_t &_cal)
+{
+	wwvb_receiver rx(*model[m]);
+
+	wwvb_tx.setPWM_HIGH(_ICR1 / 2);
+	wwvb_tx.setPWM_LOW(_PWM_LOW);
+	wwvb_tx.calibrate(_cal, _cal);
+
+	const uint32_t carrier_Hz = F_CPU / (2UL * _ICR1);
+	const uint8_t depth = wwvb_receiver::depth_dB(wwvb_tx.getPWM_LOW(), wwvb_tx.getPWM_HIGH(), _ICR1);
+	rx.carrier(carrier_Hz, depth);
+
+	wwvb_tx.set_time(12, 0, 1, 1, 16);
+
+	// isr tick period in 1/16 us : 2*ICR1 / 16MHz
+	const uint32_t tick_16th_us = 2UL * _ICR1;
+	bool is_odd_bit = true;
+
+	for (uint8_t f = 0; f < FRAMES_PER_RUN; ++f)
+	{
+		for (uint8_t i = 0; i < 60; ++i)
+		{
+			uint32_t low_us = (wwvb_tx.pulse_ticks(wwvb_tx.symbol(i)) * tick_16th_us) >> 4;
+			uint32_t period_us = (wwvb_tx.bit_ticks(is_odd_bit) * tick_16th_us) >> 4;
+			is_odd_bit = !is_odd_bit;
+
+			rx.pulse(low_us, period_us);
+		}
+		wwvb_tx.add_time(0, 1);
+	}
+
+	Serial.print(model_name[m]); Serial.print(',');
+	Serial.print(_ICR1); Serial.print(',');
+	Serial.print(carrier_Hz); Serial.print(',');
+	Serial.print(_PWM_LOW); Serial.print(',');
+	Serial.print(depth); Serial.print(',');
+	Serial.print(_cal); Serial.print(',');
+	Serial.print(rx.locked()); Serial.print(',');
+	Serial.println(rx.time_to_lock());
+}
+
+void setup()
+{
+	Serial.begin(9600);
+#if defined(__AVR_ATmega16U4__) | defined(__AVR_ATmega32U4__)
+	while (!Serial); // If using a leonardo/micro, wait for the Serial connection
+#endif
+
+	// bit timing for a 16MHz clock (see wwvb::setup), Timer1 is left alone
+	wwvb_tx.set(12030, 30075, 48120, 60150);
+
+	Serial.println(F("model,ICR1,carrier_Hz,PWM_LOW,depth_dB,calibrate,locked,time_to_lock_s"));
+
+	for (uint8_t m = 0; m < 3; ++m)
+	{
+		for (uint8_t c = 0; c < 3; ++c)
+		{
+			for (uint8_t p = 0; p < 5; ++p)
+			{
+				for (uint8_t k = 0; k < 5; ++k)
+				{
+					run(m, sweep_ICR1[c], sweep_PWM_LOW[p], sweep_calibrate[k]);
+				}
+			}
+		}
+	}
+	Serial.println(F("done"));
+}
+
+void loop()
+{
+}
@@ -0,0 +1,60 @@
+/*
+Deferred telemetry : debug_time() without blocking the sketch
+
+With WWVB_TELEMETRY defined, debug_time() and raw() add a compact binary record (see wwvb_telemetry.h)
+to a ring buffer instead of printing ~400 characters, and loop() sends it a few bytes at a time
+with telemetry.service(Serial), which never waits for the serial port.
+
+The serial output is binary, decode it on the host with wwvb_telemetry_decoder, e.g.
+
+wwvb_telemetry_decoder decoder;
+std::string text;
+while ((c = getchar()) != EOF) { if (decoder.decode(c, text)) { fputs(text.c_str(), stdout); } }
+*/
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+
+#define _DEBUG 1
+#define REQUIRE_TIMEDATESTRING 1
+#define WWVB_TELEMETRY
+
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+wwvb wwvb_tx;
+
+// The ISR sets the PWM pulse width to correspond with the WWVB bit
+ISR(TIMER1_OVF_vect)
+{
+	wwvb_tx.interrupt_routine();
+}
+
+const int8_t wwvb_timezone[2] = { -6, 0 }; // This is the timezone of your wwvb clock : CST (UTC -6:00)
+
+uint8_t mins = 0;
+
+void setup()
+{
+	wwvb_tx.setup();
+	wwvb_tx.setTimezone(-wwvb_timezone[0], -wwvb_timezone[1]);
+	wwvb_tx.set_time(__DATE__, __TIME__);
+
+	Serial.begin(9600);
+
+	wwvb_tx.debug_time(); // a snapshot of the starting state
+	mins = wwvb_tx.mm();
+
+	wwvb_tx.start(); // Thats it
+}
+
+void loop()
+{
+	// a snapshot of each new frame
+	if (mins != wwvb_tx.mm())
+	{
+		mins = wwvb_tx.mm();
+		wwvb_tx.debug_time();
+	}
+
+	wwvb_tx.telemetry.service(Serial);
+}
@@ -0,0 +1,168 @@
+/*
+Time warp calendar check
+
+Runs the wwvb interrupt routine and calendar WWVB_TIMEWARP times faster than real time
+(10ms bits, 0.6s frames) across leap days, day 366, year rollover (99 -> 00),
+the start and end of (US) daylight savings, and a leap second (61 bit frame) with a DUT1 step
+and checks every frame against the reference calendar/encoder in wwvb_frame.h
+
+Note: the output wont be decoded by a real clock, this is just for checking the frames
+
+Output is one line per case:
+case,20YY,doty,hh:mm,frames,mismatches
+followed by the expected and sent frame (hex) for any mismatch
+*/
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+
+#define _DEBUG 1
+#define REQUIRE_TIMEDATESTRING 0
+#define WWVB_TIMEWARP 100 // 1s -> 10ms
+
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+#include <wwvb_frame.h>
+#include <wwvb_dst.h>
+
+wwvb wwvb_tx;
+
+// The ISR sets the PWM pulse width to correspond with the WWVB bit
+ISR(TIMER1_OVF_vect)
+{
+	wwvb_tx.interrupt_routine();
+}
+
+#define FRAMES_PER_CASE 4
+
+// 2 minutes before each rollover
+// hh, mm, DD, MM, YY, doty (doty is the reference, it isnt derived from DD/MM)
+const uint8_t NUM_CASES = 9;
+const uint16_t cases[NUM_CASES][6] = {
+	{ 23, 58, 28,  2, 16,  59 }, // leap day 29 Feb 2016
+	{ 23, 58, 28,  2, 17,  59 }, // 28 Feb -> 1 Mar 2017
+	{ 23, 58, 31, 12, 16, 366 }, // day 366 -> 1 Jan 2017, leap second at 23:59:60
+	{ 23, 58, 31, 12, 17, 365 }, // day 365 -> 1 Jan 2018
+	{ 23, 58, 31, 12,  0, 366 }, // 2000 is a leap year
+	{ 23, 58, 31, 12, 99, 365 }, // 2099 -> 2000 (YY 99 -> 00)
+	{ 11, 58, 30,  6, 16, 182 }, // midday, end of month
+	{ 23, 58, 12,  3, 16,  72 }, // daylight savings begins 13 Mar 2016
+	{ 23, 58,  5, 11, 16, 310 }, // daylight savings ends 6 Nov 2016
+};
+
+// reference calendar
+uint8_t ref_hh, ref_mm, ref_YY;
+uint16_t ref_doty;
+
+// leap second at the end of 31 Dec 2016, DUT1 steps from -0.4 to +0.6 after it
+const wwvb_leap_second leap_seconds[1] = { { 16, 12 } };
+const wwvb_dut1_step dut1_steps[2] = { { 16, 336, -4 }, { 17, 1, 6 } };
+
+// reference DUT1 and leap second warning
+int8_t ref_dut1()
+{
+	if (ref_YY > 16) { return 6; }
+	return ((ref_YY == 16) & (ref_doty >= 336)) ? -4 : 0;
+}
+bool ref_leap_second_warning()
+{
+	return (ref_YY == 16) & (ref_doty >= 336); // 1 Dec 2016 - 31 Dec 2016
+}
+
+uint8_t case_index = 0;
+uint8_t frames = 0;
+uint8_t mismatches = 0;
+bool checked = false;
+
+void print_frame(const uint64_t &_frame)
+{
+	Serial.print((uint32_t)(_frame >> 32), HEX);
+	Serial.print(' ');
+	Serial.print((uint32_t)_frame, HEX);
+}
+
+void start_case()
+{
+	const uint16_t *c = cases[case_index];
+
+	wwvb_tx.stop();
+	wwvb_tx.set_time(c[0], c[1], c[2], c[3], c[4], WWVB_DST_AUTO);
+
+	ref_hh = c[0];
+	ref_mm = c[1];
+	ref_YY = c[4];
+	ref_doty = c[5];
+
+	frames = 0;
+	mismatches = 0;
+	checked = false;
+
+	wwvb_tx.start();
+}
+
+void setup()
+{
+	Serial.begin(9600);
+#if defined(__AVR_ATmega16U4__) | defined(__AVR_ATmega32U4__)
+	while (!Serial); // If using a leonardo/micro, wait for the Serial connection
+#endif
+	Serial.print(F("WWVB_TIMEWARP = "));
+	Serial.println(WWVB_TIMEWARP);
+	Serial.println(F("case,20YY,doty,hh:mm,frames,mismatches"));
+
+	wwvb_tx.setup();
+	wwvb_tx.setLeapSecondSchedule(leap_seconds, 1);
+	wwvb_tx.setDUT1Schedule(dut1_steps, 2);
+	start_case();
+}
+
+void loop()
+{
+	if (case_index == NUM_CASES)
+	{
+		return;
+	}
+
+	// check each frame as it starts
+	if (wwvb_tx.frame_index != 0)
+	{
+		checked = false;
+		return;
+	}
+	if (checked)
+	{
+		return;
+	}
+	checked = true;
+
+	uint64_t expected = wwvb_encode_frame(ref_hh, ref_mm, ref_doty, ref_YY, wwvb_dst_us(ref_YY, ref_doty),
+		ref_dut1(), ref_leap_second_warning());
+	uint64_t sent = wwvb_tx.frame();
+	if (sent != expected)
+	{
+		++mismatches;
+		print_frame(expected); Serial.print(F(" != ")); print_frame(sent); Serial.println();
+	}
+	wwvb_next_minute(ref_hh, ref_mm, ref_doty, ref_YY);
+
+	if (++frames == FRAMES_PER_CASE)
+	{
+		const uint16_t *c = cases[case_index];
+		Serial.print(case_index); Serial.print(',');
+		Serial.print(2000 + c[4]); Serial.print(',');
+		Serial.print(c[5]); Serial.print(',');
+		Serial.print(c[0]); Serial.print(':'); Serial.print(c[1]); Serial.print(',');
+		Serial.print(frames); Serial.print(',');
+		Serial.println(mismatches);
+
+		if (++case_index < NUM_CASES)
+		{
+			start_case();
+		}
+		else
+		{
+			wwvb_tx.stop();
+			Serial.println(F("done"));
+		}
+	}
+}
@@ -0,0 +1,84 @@
+/*
+Generic time code transmitter
+
+Sends WWVB, DCF77, MSF or JJY (40kHz or 60kHz) from the same timing core (timecode.h),
+pick the format with TIMECODE_FORMAT
+
+Set the time in the time base of the format:
+* timecode_wwvb  : UTC
+* timecode_dcf77 : CET/CEST
+* timecode_msf   : UK time
+* timecode_jjy   : JST
+
+-----------+-----------+-----------------
+Chip       | #define   | TIMECODE_OUT
+-----------+-----------+-----------------
+ATmega32u4 | *USE_OC1A | D9
+ATmega32u4 |  USE_OC1B | D10
+-----------+-----------+-----------------
+ATmega328p | *USE_OC1A | D9
+ATmega328p |  USE_OC1B | D10
+-----------+-----------+-----------------
+
+* Default setup
+*/
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+
+#define _DEBUG 1
+#define REQUIRE_TIMEDATESTRING 1
+
+#define TIMECODE_FORMAT timecode_dcf77
+
+#include <TimeDateTools.h> // include before timecode.h
+#include <timecode.h>
+
+timecode<TIMECODE_FORMAT> timecode_tx;
+
+// The ISR sets the PWM pulse width to correspond with the time code symbol
+ISR(TIMER1_OVF_vect)
+{
+	timecode_tx.interrupt_routine();
+}
+
+uint8_t mins = 0xFF;
+
+void setup()
+{
+	timecode_tx.setup();
+
+	//timecode_tx.setPWM_LOW(0); // sets the pulsewidth for the reduced carrier : 0 - ICR1 = 0 - 100%
+
+	timecode_tx.set_time(__DATE__, __TIME__);
+
+#if (_DEBUG > 0)
+	Serial.begin(9600);
+#if defined(__AVR_ATmega16U4__) | defined(__AVR_ATmega32U4__)
+	while (!Serial); // If using a leonardo/micro, wait for the Serial connection
+#endif
+	Serial.print(F("carrier = "));
+	Serial.print(TIMECODE_FORMAT::carrier_Hz);
+	Serial.println(F("Hz"));
+#endif
+
+	timecode_tx.start(); // Thats it
+}
+
+void loop()
+{
+#if (_DEBUG > 0)
+	if (mins != timecode_tx.mm())
+	{
+		mins = timecode_tx.mm();
+
+		// the time in the frame being sent, and its symbols
+		print_datetime(timecode_tx.hh(), timecode_tx.mm(), timecode_tx.DD(), timecode_tx.MM(), timecode_tx.YY());
+		for (uint8_t i = 0; i < TIMECODE_FORMAT::seconds; ++i)
+		{
+			Serial.print(timecode_tx.symbol(i));
+		}
+		Serial.println();
+	}
+#endif
+}
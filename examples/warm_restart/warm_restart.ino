@@ -0,0 +1,75 @@
+/*
+Warm restart : resume the wwvb frames straight away after a brown-out or reset
+
+On boot the time, calibration and daylight savings mode are restored from EEPROM (see wwvb_state.h),
+the time being the minute after the last checkpoint. If nothing has been saved yet the compile time is used.
+The state is checkpointed every CHECKPOINT_MINS minutes at the start of a frame.
+
+Without an rtc the restored time is late by the time spent in reset plus up to CHECKPOINT_MINS minutes
+(the minutes sent since the last checkpoint), so a receiver set from it is only as good as that.
+
+A restored time is WWVB_QUALITY_DEGRADED until wwvb_checkpoint.synced() is called,
+e.g. after the time is set from gps (see examples/gps_time_sync)
+
+To restore from an rtc instead, fill in a wwvb_rtc with your rtc read / write functions
+and pass it to wwvb_checkpoint.setRTC(). The frames then resume at the rtc second.
+*/
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+
+#define _DEBUG 0
+#define REQUIRE_TIMEDATESTRING 1
+
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+#include <wwvb_state.h>
+
+wwvb wwvb_tx;
+wwvb_state wwvb_checkpoint(0, 32); // 32 records from EEPROM address 0 (384 bytes)
+
+#define CHECKPOINT_MINS 10
+
+// The ISR sets the PWM pulse width to correspond with the WWVB bit
+ISR(TIMER1_OVF_vect)
+{
+	wwvb_tx.interrupt_routine();
+}
+
+const int8_t wwvb_timezone[2] = { -6, 0 }; // This is the timezone of your wwvb clock : CST (UTC -6:00)
+
+uint8_t mins = 0;
+
+void setup()
+{
+	wwvb_tx.setup();
+	wwvb_tx.setTimezone(-wwvb_timezone[0], -wwvb_timezone[1]);
+
+	Serial.begin(9600);
+
+	if (wwvb_checkpoint.restore(wwvb_tx))
+	{
+		Serial.print(F("restored (degraded) : "));
+	}
+	else
+	{
+		wwvb_tx.set_time(__DATE__, __TIME__);
+		Serial.print(F("compile time : "));
+	}
+	wwvb_tx.print();
+
+	mins = wwvb_tx.mm();
+	wwvb_tx.start(wwvb_checkpoint.secs()); // Thats it (0 unless restored from an rtc)
+}
+
+void loop()
+{
+	if (mins != wwvb_tx.mm())
+	{
+		mins = wwvb_tx.mm();
+		if ((mins % CHECKPOINT_MINS) == 0)
+		{
+			wwvb_checkpoint.save(wwvb_tx);
+		}
+	}
+}
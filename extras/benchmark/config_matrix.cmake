@@ -0,0 +1,72 @@
+# Configuration matrix driver : cmake -DMANIFEST=<file> -DOUTPUT=<csv> -DNM=<nm> [-DAVR_NM=<avr-nm>] -P config_matrix.cmake
+#
+# Walks every configuration in MANIFEST (one per line : name|config_matrix executable|host size object|avr size object),
+# runs its benchmark and reads the per function code size of its size object(s), and writes them all as one csv table
+#
+# config,F_CPU,USE_OC1B,WWVB_PAM,WWVB_MODULATION_OUT,WWVB_PM,_DEBUG,WWVB_TIMEWARP,metric,name,value
+#
+# metric : sizeof, isr_calls, isr_min/mean/max_<unit> (see config_matrix.cpp),
+#          host_function_bytes and avr_function_bytes (only with avr-g++) per wwvb function
+#
+# Copyright (c) 2015 Mark Cooke, Martin Sniedze
+# Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+# License: MIT license (see LICENSE file).
+
+cmake_policy(VERSION 3.13)
+
+foreach(_var MANIFEST OUTPUT NM)
+	if(NOT DEFINED ${_var})
+		message(FATAL_ERROR "config_matrix.cmake : ${_var} is not set")
+	endif()
+endforeach()
+
+# append a row per wwvb function in _object (nm --size-sort -S -C) to the variable named _out
+function(function_rows _out _prefix _nm _object _metric)
+	execute_process(COMMAND ${_nm} --size-sort -S -C ${_object}
+		OUTPUT_VARIABLE _symbols RESULT_VARIABLE _result)
+	if(NOT _result EQUAL 0)
+		message(FATAL_ERROR "config_matrix.cmake : ${_nm} ${_object} failed")
+	endif()
+	string(REPLACE "\n" ";" _symbols "${_symbols}")
+	set(_rows "")
+	foreach(_symbol IN LISTS _symbols)
+		if(_symbol MATCHES "^[0-9a-fA-F]+ ([0-9a-fA-F]+) [tTwW] (.*wwvb.*)$")
+			math(EXPR _bytes "0x${CMAKE_MATCH_1}")
+			string(REPLACE "\"" "\"\"" _name "${CMAKE_MATCH_2}")
+			string(APPEND _rows "${_prefix},${_metric},\"${_name}\",${_bytes}\n")
+		endif()
+	endforeach()
+	set(${_out} "${${_out}}${_rows}" PARENT_SCOPE)
+endfunction()
+
+file(STRINGS ${MANIFEST} _configs)
+list(LENGTH _configs _count)
+if(_count EQUAL 0)
+	message(FATAL_ERROR "config_matrix.cmake : no configurations in ${MANIFEST}")
+endif()
+
+set(_table "config,F_CPU,USE_OC1B,WWVB_PAM,WWVB_MODULATION_OUT,WWVB_PM,_DEBUG,WWVB_TIMEWARP,metric,name,value\n")
+foreach(_config IN LISTS _configs)
+	string(REPLACE "|" ";" _fields "${_config}")
+	list(GET _fields 0 _name)
+	list(GET _fields 1 _executable)
+	list(GET _fields 2 _host_object)
+	list(GET _fields 3 _avr_object)
+
+	execute_process(COMMAND ${_executable} OUTPUT_VARIABLE _rows RESULT_VARIABLE _result)
+	if(NOT _result EQUAL 0 OR NOT _rows MATCHES "^${_name},")
+		message(FATAL_ERROR "config_matrix.cmake : ${_name} failed (${_result})")
+	endif()
+	string(APPEND _table "${_rows}")
+
+	# the configuration columns of this configuration
+	string(REGEX MATCH "^[^,]*,[^,]*,[^,]*,[^,]*,[^,]*,[^,]*,[^,]*,[^,]*" _prefix "${_rows}")
+
+	function_rows(_table "${_prefix}" ${NM} ${_host_object} host_function_bytes)
+	if(_avr_object AND AVR_NM)
+		function_rows(_table "${_prefix}" ${AVR_NM} ${_avr_object} avr_function_bytes)
+	endif()
+endforeach()
+
+file(WRITE ${OUTPUT} "${_table}")
+message(STATUS "config_matrix.cmake : ${_count} configurations -> ${OUTPUT}")
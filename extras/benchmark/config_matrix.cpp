@@ -0,0 +1,174 @@
+/*
+Configuration matrix benchmark (host)
+
+The host build of examples/benchmark : built once per configuration (see extras/CMakeLists.txt),
+it prints the cost of its configuration as rows of the configuration matrix table (see config_matrix.cmake)
+
+config,F_CPU,USE_OC1B,WWVB_PAM,WWVB_MODULATION_OUT,WWVB_PM,_DEBUG,WWVB_TIMEWARP,metric,name,value
+
+metric
+* sizeof                        : sizeof(wwvb)
+* isr_calls                     : interrupt_routine() calls per path
+* isr_min_<unit> / _mean / _max : host cycles (rdtsc) or ns per path, less the cost of an empty measurement
+
+The isr paths are the same as examples/benchmark (tick, edge, bit, minute, day) for a simulated 23:59 -> 00:01,
+the simulated clock (host_cycles, see Arduino.h) is stepped one Timer1 overflow per call so the 8MHz (millis) timing works.
+The host numbers rank the configurations, the AVR cycles come from running examples/benchmark on the target.
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+
+#if !defined(_DEBUG)
+#define _DEBUG 0
+#endif
+#define REQUIRE_TIMEDATESTRING 0
+
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+
+#if defined(__x86_64__) | defined(__i386__)
+#include <x86intrin.h>
+#define HOST_COUNTER_UNIT "cycles"
+inline uint64_t host_counter()
+{
+	_mm_lfence();
+	const uint64_t _t = __rdtsc();
+	_mm_lfence();
+	return _t;
+}
+#else
+#include <chrono>
+#define HOST_COUNTER_UNIT "ns"
+inline uint64_t host_counter()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+wwvb wwvb_tx;
+
+#define PATHS 5
+const char *path_name[PATHS] = { "tick", "edge", "bit", "minute", "day" };
+uint64_t path_calls[PATHS];
+uint64_t path_total[PATHS];
+uint64_t path_min[PATHS];
+uint64_t path_max[PATHS];
+
+uint64_t overhead = 0;
+
+// host cycles of one interrupt_routine() call, less the measurement overhead (never below 0)
+uint64_t measure(const bool _empty = false)
+{
+	const uint64_t _t0 = host_counter();
+	if (!_empty)
+	{
+		wwvb_tx.interrupt_routine();
+	}
+	const uint64_t _t = host_counter() - _t0;
+	return (_t > overhead) ? _t - overhead : 0;
+}
+
+void row(const char *_metric, const char *_name, const uint64_t &_value)
+{
+#if defined(USE_OC1B)
+	const int _oc1b = 1;
+#else
+	const int _oc1b = 0;
+#endif
+#if defined(WWVB_PAM)
+	const int _pam = 1;
+#else
+	const int _pam = 0;
+#endif
+#if defined(WWVB_MODULATION_OUT)
+	const int _modulation_out = 1;
+#else
+	const int _modulation_out = 0;
+#endif
+#if defined(WWVB_PM)
+	const int _pm = 1;
+#else
+	const int _pm = 0;
+#endif
+	printf("%s,%lu,%d,%d,%d,%d,%d,%d,%s,%s,%llu\n", CONFIG_NAME, (unsigned long)F_CPU, _oc1b, _pam, _modulation_out, _pm,
+		_DEBUG, WWVB_TIMEWARP, _metric, _name, (unsigned long long)_value);
+}
+
+int main()
+{
+	row("sizeof", "wwvb", sizeof(wwvb));
+
+	sei();
+	wwvb_tx.setup();
+	wwvb_tx.set_time(23, 59, 31, 12, 16);
+	wwvb_tx.start();
+
+	// the smallest of many empty measurements
+	overhead = 0;
+	uint64_t _overhead = ~0ULL;
+	for (uint16_t i = 0; i < 1000; ++i)
+	{
+		const uint64_t _t = measure(true);
+		if (_t < _overhead) { _overhead = _t; }
+	}
+	overhead = _overhead;
+
+	for (uint8_t p = 0; p < PATHS; ++p)
+	{
+		path_calls[p] = 0;
+		path_total[p] = 0;
+		path_min[p] = ~0ULL;
+		path_max[p] = 0;
+	}
+
+	// 2 frames : 23:59 and 00:00 (the first bit of the 00:01 frame ends it)
+	uint8_t _frames = 0;
+	while (_frames < 2)
+	{
+		host_cycles += host_timer1_period(); // the time of the next Timer1 overflow
+
+		const uint8_t _frame_index = wwvb_tx.frame_index;
+		const uint8_t _DD = wwvb_tx.DD();
+		const bool _led = digitalRead(LED_BUILTIN); // the isr sets the LED high on the edge, low at the start of a bit
+		const uint64_t _cycles = measure();
+
+		uint8_t p = 0; // tick
+		if (wwvb_tx.frame_index != _frame_index)
+		{
+			p = 2; // bit
+			if (wwvb_tx.frame_index == 0)
+			{
+				p = (wwvb_tx.DD() != _DD) ? 4 : 3; // day, minute
+				++_frames;
+			}
+		}
+		else if (!_led && digitalRead(LED_BUILTIN))
+		{
+			p = 1; // edge
+		}
+
+		++path_calls[p];
+		path_total[p] += _cycles;
+		if (_cycles < path_min[p]) { path_min[p] = _cycles; }
+		if (_cycles > path_max[p]) { path_max[p] = _cycles; }
+	}
+
+	for (uint8_t p = 0; p < PATHS; ++p)
+	{
+		row("isr_calls", path_name[p], path_calls[p]);
+		if (path_calls[p] == 0)
+		{
+			continue;
+		}
+		row("isr_min_" HOST_COUNTER_UNIT, path_name[p], path_min[p]);
+		row("isr_mean_" HOST_COUNTER_UNIT, path_name[p], path_total[p] / path_calls[p]);
+		row("isr_max_" HOST_COUNTER_UNIT, path_name[p], path_max[p]);
+	}
+	return 0;
+}
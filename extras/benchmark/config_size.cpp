@@ -0,0 +1,42 @@
+/*
+Per function code size of a configuration
+
+A minimal sketch (like examples/minimum) compiled with -Os -fno-inline, so each wwvb member function it uses
+is a separate symbol : nm --size-sort -S -C gives the bytes per function (see config_matrix.cmake).
+It is compiled with the host compiler, and with avr-g++ if it is installed (the AVR code size).
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+
+#if !defined(_DEBUG)
+#define _DEBUG 0
+#endif
+#define REQUIRE_TIMEDATESTRING 0
+
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+wwvb wwvb_tx;
+
+ISR(TIMER1_OVF_vect)
+{
+	wwvb_tx.interrupt_routine();
+}
+
+void setup()
+{
+	wwvb_tx.setup();
+	wwvb_tx.set_time(23, 59, 31, 12, 16);
+	wwvb_tx.start();
+}
+
+void loop()
+{
+	wwvb_tx.debug_time();
+}
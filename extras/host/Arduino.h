@@ -0,0 +1,235 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+/*
+Host stand-in for <Arduino.h> (the library and the host build, not the Arduino core)
+
+Lets the wwvb headers and examples build with the host compiler for the tests, tools and benchmarks in extras/.
+The Timer1 registers are plain variables, and the host runner (host_main.cpp) steps a simulated clock
+one Timer1 overflow at a time and calls ISR(TIMER1_OVF_vect), so millis() / micros() follow the isr.
+
+simulated clock : host_cycles, in F_CPU cycles since reset
+host_tick()     : advance to the next Timer1 overflow (or 1ms if Timer1 is stopped) and run the isr
+host_reset()    : the power on registers, pins and clock
+Serial          : prints to host_serial (stdout, or e.g. a tmpfile() to check the text in a test)
+
+The registers, pins and clock are per thread (thread_local), so each thread is its own simulated ATmega328p,
+e.g. the parallel trials of extras/host/wwvb_montecarlo_isr.h
+
+With avr-gcc (__AVR__) the real avr-libc headers are used, and the Arduino functions are only declared,
+so a translation unit can be compiled (not linked) for per function code size
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#if !defined(F_CPU)
+#define F_CPU 16000000UL
+#endif
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define LED_BUILTIN 13
+
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+#if defined(__AVR__)
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+void pinMode(uint8_t _pin, uint8_t _mode);
+void digitalWrite(uint8_t _pin, uint8_t _value);
+int digitalRead(uint8_t _pin);
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long _ms);
+
+inline void host_write(const char *_s, const size_t &_n) { (void)_s; (void)_n; }
+#else
+// The host is an ATmega328p
+#if !defined(__AVR_ATmega328P__)
+#define __AVR_ATmega328P__
+#endif
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+#define _BV(bit) (1 << (bit))
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+// Timer1 (ATmega328p bit positions)
+inline thread_local volatile uint8_t SREG = 0;
+inline thread_local volatile uint8_t TCCR1A = 0, TCCR1B = 0, TIMSK1 = 0, TIFR1 = 0;
+inline thread_local volatile uint16_t ICR1 = 0, OCR1A = 0, OCR1B = 0, TCNT1 = 0;
+
+#define SREG_I 7
+#define WGM10 0
+#define WGM11 1
+#define COM1B0 4
+#define COM1B1 5
+#define COM1A0 6
+#define COM1A1 7
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define WGM12 3
+#define WGM13 4
+#define TOIE1 0
+#define TOV1 0
+
+#define ISR(vector, ...) extern "C" void vector(void)
+extern "C" void TIMER1_OVF_vect(void) __attribute__((weak));
+
+inline void cli() { SREG &= ~_BV(SREG_I); }
+inline void sei() { SREG |= _BV(SREG_I); }
+
+// simulated clock
+inline thread_local volatile uint64_t host_cycles = 0;
+
+// Timer1 overflow period in F_CPU cycles, 0 if Timer1 is stopped
+inline uint32_t host_timer1_period()
+{
+	static const uint16_t _prescaler[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+	const uint16_t _p = _prescaler[TCCR1B & 0x07];
+	const uint8_t _mode = ((TCCR1B >> WGM12) & 0x03) << 2 | (TCCR1A & 0x03);
+	switch (_mode)
+	{
+	case 8:  // phase & frequency correct PWM, TOP = ICR1 : 0 -> ICR1 -> 0
+		return 2UL * ICR1 * _p;
+	case 14: // fast PWM, TOP = ICR1
+		return (ICR1 + 1UL) * _p;
+	}
+	return 65536UL * _p; // normal
+}
+
+// advance to the next Timer1 overflow and run the isr (if it is enabled), or 1ms if Timer1 is stopped
+inline void host_tick()
+{
+	const uint32_t _period = host_timer1_period();
+	if (_period == 0)
+	{
+		host_cycles += F_CPU / 1000;
+		return;
+	}
+	host_cycles += _period;
+	if ((TIMSK1 & _BV(TOIE1)) && (SREG & _BV(SREG_I)) && (TIMER1_OVF_vect != 0))
+	{
+		cli();
+		TIMER1_OVF_vect();
+		sei();
+	}
+}
+
+inline unsigned long millis() { return (unsigned long)(host_cycles / (F_CPU / 1000UL)); }
+inline unsigned long micros() { return (unsigned long)(host_cycles / (F_CPU / 1000000UL)); }
+inline void delay(unsigned long _ms)
+{
+	const uint64_t _end = host_cycles + (uint64_t)_ms * (F_CPU / 1000UL);
+	while (host_cycles < _end) { host_tick(); }
+}
+
+inline thread_local volatile uint8_t host_pins[32];
+inline thread_local volatile uint8_t host_pin_modes[32];
+inline void pinMode(uint8_t _pin, uint8_t _mode) { host_pin_modes[_pin & 0x1F] = _mode; }
+inline void digitalWrite(uint8_t _pin, uint8_t _value) { host_pins[_pin & 0x1F] = _value; }
+inline int digitalRead(uint8_t _pin) { return host_pins[_pin & 0x1F]; }
+
+// power on state of this thread's simulated ATmega328p
+inline void host_reset()
+{
+	SREG = 0;
+	TCCR1A = 0; TCCR1B = 0; TIMSK1 = 0; TIFR1 = 0;
+	ICR1 = 0; OCR1A = 0; OCR1B = 0; TCNT1 = 0;
+	host_cycles = 0;
+	for (uint8_t i = 0; i < 32; ++i) { host_pins[i] = LOW; host_pin_modes[i] = INPUT; }
+}
+
+inline FILE *host_serial = stdout;
+inline void host_write(const char *_s, const size_t &_n) { fwrite(_s, 1, _n, host_serial); }
+#endif
+
+template <typename T, typename U>
+inline T min(const T &_a, const U &_b) { return (_a < (T)_b) ? _a : (T)_b; }
+template <typename T, typename U>
+inline T max(const T &_a, const U &_b) { return (_a > (T)_b) ? _a : (T)_b; }
+
+// Serial (print / println as in the Arduino Print class)
+class HardwareSerial
+{
+private:
+	size_t number(const unsigned long long &_value, const uint8_t &_base)
+	{
+		char _buffer[8 * sizeof(long long) + 1];
+		char *_s = &_buffer[sizeof(_buffer) - 1];
+		*_s = '\0';
+		unsigned long long _n = _value;
+		do
+		{
+			const uint8_t _digit = _n % _base;
+			*--_s = (_digit < 10) ? '0' + _digit : 'A' + _digit - 10;
+			_n /= _base;
+		} while (_n);
+		return print(_s);
+	}
+	size_t signed_number(const long long &_value, const uint8_t &_base)
+	{
+		if ((_base == DEC) && (_value < 0))
+		{
+			return print('-') + number(-(unsigned long long)_value, _base);
+		}
+		return number((unsigned long long)_value & ((_base == DEC) ? ~0ULL : 0xFFFFFFFFULL), _base);
+	}
+public:
+	void begin(unsigned long _baud) { (void)_baud; }
+	void flush() { fflush(host_serial); }
+	int available() { return 0; }
+	int read() { return -1; }
+	int availableForWrite() { return 63; }
+	operator bool() { return true; }
+
+	size_t write(uint8_t _c) { host_write((const char *)&_c, 1); return 1; }
+	size_t write(const uint8_t *_buffer, size_t _n) { host_write((const char *)_buffer, _n); return _n; }
+
+	size_t print(const __FlashStringHelper *_s) { return print(reinterpret_cast<const char *>(_s)); }
+	size_t print(const char *_s) { const size_t _n = strlen(_s); host_write(_s, _n); return _n; }
+	size_t print(char _c) { host_write(&_c, 1); return 1; }
+	size_t print(unsigned char _n, int _base = DEC) { return number(_n, _base); }
+	size_t print(int _n, int _base = DEC) { return signed_number(_n, _base); }
+	size_t print(unsigned int _n, int _base = DEC) { return number(_n, _base); }
+	size_t print(long _n, int _base = DEC) { return signed_number(_n, _base); }
+	size_t print(unsigned long _n, int _base = DEC) { return number(_n, _base); }
+	size_t print(double _n, int _digits = 2)
+	{
+		char _buffer[32];
+		const int _length = snprintf(_buffer, sizeof(_buffer), "%.*f", _digits, _n);
+		return print((_length > 0) ? _buffer : "");
+	}
+
+	size_t println() { return print('\n'); }
+	template <typename T>
+	size_t println(const T &_value) { return print(_value) + println(); }
+	template <typename T>
+	size_t println(const T &_value, int _format) { return print(_value, _format) + println(); }
+};
+inline HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef TimeDateTools_h
+#define TimeDateTools_h
+
+/*
+Host stand-in for TimeDateTools.h (https://github.com/micooke/ATtinyGPS)
+
+The calendar functions the wwvb library uses, with the same names and parameters.
+addTimezone handles negative offsets (borrowing from the day, month and year) as well as positive ones.
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+
+inline bool is_leap_year(const uint16_t &_year)
+{
+	return ((_year % 4 == 0) & (_year % 100 != 0)) | (_year % 400 == 0);
+}
+
+inline uint8_t days_in_month(const uint8_t &_MM, const bool &_is_leap_year)
+{
+	static const uint8_t _days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	return _days[(_MM - 1) % 12] + ((_MM == 2) & _is_leap_year);
+}
+
+// 1 = 1 Jan, 365 = 31 Dec (or 366 in a leap year)
+template <typename T>
+uint16_t to_day_of_the_year(const T &_DD, const T &_MM, const bool &_is_leap_year)
+{
+	static const uint16_t _month_start[12] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+	const uint8_t _MM_ = _MM;
+	return _month_start[(_MM_ - 1) % 12] + _DD + ((_MM_ > 2) & _is_leap_year);
+}
+
+template <typename T>
+void from_day_of_the_year(uint16_t _doty, T &_DD, T &_MM, const bool &_is_leap_year)
+{
+	uint8_t _month = 1;
+	while ((_month < 12) & (_doty > days_in_month(_month, _is_leap_year)))
+	{
+		_doty -= days_in_month(_month, _is_leap_year);
+		++_month;
+	}
+	_DD = _doty;
+	_MM = _month;
+}
+
+// add (or take off) a time offset, e.g. a timezone, rolling over the day, month and year (20YY)
+template <typename T>
+void addTimezone(T &_hh, T &_mm, T &_ss, T &_DD, T &_MM, T &_YY,
+	const int8_t &_hh_offset, const int8_t &_mm_offset, const int8_t &_ss_offset)
+{
+	int16_t _secs = (int16_t)_ss + _ss_offset;
+	int16_t _mins = (int16_t)_mm + _mm_offset;
+	int16_t _hour = (int16_t)_hh + _hh_offset;
+	int8_t _days = 0;
+
+	while (_secs < 0) { _secs += 60; --_mins; }
+	while (_secs >= 60) { _secs -= 60; ++_mins; }
+	while (_mins < 0) { _mins += 60; --_hour; }
+	while (_mins >= 60) { _mins -= 60; ++_hour; }
+	while (_hour < 0) { _hour += 24; --_days; }
+	while (_hour >= 24) { _hour -= 24; ++_days; }
+
+	uint8_t _day = _DD, _month = _MM, _year = _YY;
+	for (; _days > 0; --_days)
+	{
+		if (++_day > days_in_month(_month, is_leap_year(2000 + _year)))
+		{
+			_day = 1;
+			if (++_month > 12)
+			{
+				_month = 1;
+				_year = (_year + 1) % 100;
+			}
+		}
+	}
+	for (; _days < 0; ++_days)
+	{
+		if (--_day == 0)
+		{
+			if (--_month == 0)
+			{
+				_month = 12;
+				_year = (_year + 99) % 100;
+			}
+			_day = days_in_month(_month, is_leap_year(2000 + _year));
+		}
+	}
+
+	_ss = _secs;
+	_mm = _mins;
+	_hh = _hour;
+	_DD = _day;
+	_MM = _month;
+	_YY = _year;
+}
+
+// hh:mm on DD/MM/20YY (see wwvb_debugging.txt)
+inline void print_datetime(const uint8_t _hh, const uint8_t _mm, const uint8_t _DD, const uint8_t _MM, const uint8_t _YY)
+{
+	char _buffer[32]; // room for 3 digits a field, so -Wformat-truncation has nothing to warn about
+	snprintf(_buffer, sizeof(_buffer), "%02u:%02u on %02u/%02u/20%02u", _hh, _mm, _DD, _MM, _YY);
+	Serial.println(_buffer);
+}
+
+// __DATE__ : "Mmm DD YYYY"
+inline void DateString_to_DDMMYY(const char *_dateString, uint8_t &_DD, uint8_t &_MM, uint8_t &_YY)
+{
+	static const char _months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+	_MM = 1;
+	for (uint8_t i = 0; i < 12; ++i)
+	{
+		if (strncmp(_dateString, _months + 3 * i, 3) == 0) { _MM = i + 1; }
+	}
+	_DD = atoi(_dateString + 4);
+	_YY = atoi(_dateString + 7) % 100;
+}
+
+// __TIME__ : "hh:mm:ss"
+inline void TimeString_to_HHMMSS(const char *_timeString, uint8_t &_hh, uint8_t &_mm, uint8_t &_ss)
+{
+	_hh = atoi(_timeString);
+	_mm = atoi(_timeString + 3);
+	_ss = atoi(_timeString + 6);
+}
+
+#endif
@@ -0,0 +1,6 @@
+// Host stand-in for <avr/interrupt.h> : ISR(), cli() and sei() are in the host Arduino.h
+#if defined(__AVR__)
+#include_next <avr/interrupt.h>
+#else
+#include <Arduino.h>
+#endif
@@ -0,0 +1,27 @@
+// Host stand-in for <avr/sleep.h> : sleep_cpu() sleeps until the next Timer1 overflow (see host_tick)
+#if defined(__AVR__)
+#include_next <avr/sleep.h>
+#else
+#ifndef host_avr_sleep_h
+#define host_avr_sleep_h
+
+#include <Arduino.h>
+
+#define SLEEP_MODE_IDLE 0
+
+inline volatile uint8_t host_sleep_mode = SLEEP_MODE_IDLE;
+inline volatile bool host_sleep_enabled = false;
+
+inline void set_sleep_mode(const uint8_t _mode) { host_sleep_mode = _mode; }
+inline void sleep_enable() { host_sleep_enabled = true; }
+inline void sleep_disable() { host_sleep_enabled = false; }
+inline void sleep_cpu()
+{
+	if (host_sleep_enabled)
+	{
+		host_tick();
+	}
+}
+
+#endif
+#endif
@@ -0,0 +1,37 @@
+/*
+Host runner for an example sketch : setup(), then loop() with the simulated Timer1 (see host_tick in Arduino.h)
+
+usage : <sketch> [seconds]
+Runs for the given number of simulated seconds (HOST_SECONDS by default)
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+
+#if !defined(HOST_SECONDS)
+#define HOST_SECONDS 10
+#endif
+
+void setup();
+void loop();
+
+int main(int argc, char *argv[])
+{
+	const uint64_t _seconds = (argc > 1) ? strtoull(argv[1], 0, 10) : HOST_SECONDS;
+	const uint64_t _end = _seconds * F_CPU;
+
+	sei();
+	setup();
+	while (host_cycles < _end)
+	{
+		loop();
+		host_tick();
+	}
+	Serial.flush();
+	return 0;
+}
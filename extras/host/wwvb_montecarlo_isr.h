@@ -0,0 +1,159 @@
+#ifndef wwvb_montecarlo_isr_h
+#define wwvb_montecarlo_isr_h
+
+/*
+Monte Carlo driver for the real interrupt routine (host build only)
+
+Runs the wwvb_montecarlo.h trials with the library itself as the transmitter rather than the tick model :
+a wwvb is set up for the grid point (calibrate(), ICR1, setPWM_LOW()) and wwvb::interrupt_routine() is run
+from the simulated Timer1 (extras/host/Arduino.h) for every overflow, and the edges it makes on LED_BUILTIN
+(low at the start of a bit, high at the end of the pulse) are timed and fed to the receiver model.
+
+* crystal error : the simulated clock runs in nominal F_CPU cycles, each is 1 / (F_CPU * (1 + crystal error)) seconds
+* lost ticks    : a lost Timer1 overflow advances the clock without running the isr
+* isr latency   : each edge is seen 0 - latency_cycles cpu cycles after its overflow
+
+Trials are seeded like wwvb_montecarlo() (seed = point * trials + trial), so with no crystal error, lost ticks or
+latency the frame period error and lock are the same as the tick model's (see extras/test/montecarlo_isr.cpp).
+The Timer1 registers, pins and simulated clock of extras/host/Arduino.h are per thread, and each trial starts from
+host_reset(), so the trials share the work stealing pool of wwvb_montecarlo() (wwvb_mc_parallel) and the results
+dont depend on the number of threads.
+
+Include it once per program (it defines the Timer1 isr), after wwvb.h with WWVB_TIMEWARP 1.
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+#include <wwvb_montecarlo.h>
+
+#if (WWVB_TIMEWARP != 1)
+#pragma message("ERROR : wwvb_montecarlo_isr.h needs real time bits, WWVB_TIMEWARP must be 1")
+#endif
+
+// the transmitter of the trial being run on this thread
+inline thread_local wwvb *wwvb_mc_isr_tx = 0;
+
+ISR(TIMER1_OVF_vect)
+{
+	wwvb_mc_isr_tx->interrupt_routine();
+}
+
+// One trial of the real interrupt routine feeding one receiver
+inline void wwvb_mc_isr_trial(const wwvb_mc_config &_cfg, const wwvb_mc_point &_point,
+	const uint64_t &_seed, wwvb_mc_result &_result)
+{
+	wwvb_mc_random _rng(_seed);
+
+	const double _f_cpu = _cfg.f_cpu * (1.0 + (2.0 * _rng.uniform() - 1.0) * _cfg.crystal_ppm * 1e-6);
+	const double _cycle_us = 1e6 / _f_cpu;
+	const double _lost = _cfg.lost_tick_ppm * 1e-6;
+
+	host_reset();
+	wwvb _tx;
+	wwvb_mc_isr_tx = &_tx;
+	_tx.setup();
+	_tx.set(_cfg.pulse_ticks[0], _cfg.pulse_ticks[1], _cfg.pulse_ticks[2], _cfg.endofbit);
+	_tx.calibrate(_point.calibrate, _point.calibrate);
+	_tx.setPWM_LOW(_point.pwm_low);
+	_tx.setPWM_HIGH(_cfg.pwm_high);
+	ICR1 = _point.icr1;
+
+	wwvb_receiver _rx(_cfg.model);
+	_rx.carrier((uint32_t)(_f_cpu / (2.0 * _point.icr1) + 0.5),
+		wwvb_receiver::depth_dB(_point.pwm_low, _cfg.pwm_high, _point.icr1));
+
+	// random start time, so the frames arent all the same
+	uint8_t _hour = _rng.next() % 24, _mins = _rng.next() % 60, _YY = _rng.next() % 100;
+	uint8_t _DD, _MM;
+	from_day_of_the_year<uint8_t>(1 + _rng.next() % 365, _DD, _MM, is_leap_year(2000 + _YY));
+	_tx.set_time(_hour, _mins, _DD, _MM, _YY);
+
+	// overflows until the next lost one (geometric)
+	uint64_t _tick = 0;
+	uint64_t _next_lost = ~0ULL;
+	if (_lost > 0)
+	{
+		_next_lost = 1 + (uint64_t)(log(1.0 - _rng.uniform()) / log(1.0 - _lost));
+	}
+
+	// the first bit starts at start()
+	digitalWrite(LED_BUILTIN, LOW);
+	_tx.start();
+	bool _led = false;
+	double _fall_us = host_cycles * _cycle_us;
+	double _rise_us = _fall_us;
+	double _frame_us = _fall_us;
+
+	uint8_t _frames = 0;
+	while (_frames < _cfg.frames)
+	{
+		host_cycles += host_timer1_period();
+		if (++_tick == _next_lost)
+		{
+			_next_lost += 1 + (uint64_t)(log(1.0 - _rng.uniform()) / log(1.0 - _lost));
+			continue;
+		}
+		TIMER1_OVF_vect();
+
+		const bool _now = digitalRead(LED_BUILTIN);
+		if (_now == _led)
+		{
+			continue;
+		}
+		_led = _now;
+		const double _t_us = (host_cycles + _rng.uniform() * _cfg.latency_cycles) * _cycle_us;
+		if (_now)
+		{
+			_rise_us = _t_us;
+			continue;
+		}
+
+		// start of the next bit
+		_rx.pulse((uint32_t)(_rise_us - _fall_us), (uint32_t)(_t_us - _fall_us));
+		_fall_us = _t_us;
+		if (_tx.frame_index != 0)
+		{
+			continue;
+		}
+
+		const double _error_us = _t_us - _frame_us - 60e6;
+		_frame_us = _t_us;
+		++_frames;
+		++_result.frames;
+		_result.frame_error_us += _error_us;
+		_result.frame_error2_us += _error_us * _error_us;
+		if (fabs(_error_us) > _result.frame_error_max_us) { _result.frame_error_max_us = fabs(_error_us); }
+		int32_t _bin = (int32_t)floor(_error_us / WWVB_MC_BIN_us) + WWVB_MC_BINS / 2;
+		_bin = (_bin < 0) ? 0 : ((_bin >= WWVB_MC_BINS) ? WWVB_MC_BINS - 1 : _bin);
+		++_result.histogram[_bin];
+	}
+	_tx.stop();
+	wwvb_mc_isr_tx = 0;
+
+	++_result.trials;
+	if (_rx.locked())
+	{
+		++_result.locked;
+		_result.lock_seconds += _rx.time_to_lock();
+	}
+}
+
+// Run _trials real transmitters for every point of the grid on _threads threads (0 = all cores), like wwvb_montecarlo()
+// _results must have room for _points results
+inline void wwvb_montecarlo_isr(const wwvb_mc_config &_cfg, const wwvb_mc_point *_grid, const uint32_t &_points,
+	const uint32_t &_trials, wwvb_mc_result *_results, uint32_t _threads = 0)
+{
+	wwvb_mc_parallel(_points, _trials, _results, _threads,
+		[&](const uint32_t &_point, const uint64_t &_seed, wwvb_mc_result &_result)
+		{
+			wwvb_mc_isr_trial(_cfg, _grid[_point], _seed, _result);
+		});
+}
+
+#endif
@@ -0,0 +1,146 @@
+/*
+SIMD == scalar test of the bulk frame encoder (wwvb_frame.h)
+
+wwvb_encode_bulk (SSE2, or AVX2 when built with -mavx2) is compared with wwvb_encode_bulk_scalar and
+wwvb_encode_frame for every hour and minute, every day of every year, every DUT1 (-9 to +9),
+daylight savings code and leap second warning, and pseudo-random fields.
+The counts arent a multiple of the SIMD lanes, so the scalar tail is covered too.
+wwvb_encode_frames (the range encoder) is checked against wwvb_encode_frame with DUT1 and the leap second warning.
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+#include <wwvb_frame.h>
+#include "wwvb_test.h"
+
+struct bulk_fields
+{
+	std::vector<uint8_t> hour, mins, YY, daylight_savings, leap_second_warning;
+	std::vector<uint16_t> doty;
+	std::vector<int8_t> dut1;
+
+	void add(const uint8_t &_hour, const uint8_t &_mins, const uint16_t &_doty, const uint8_t &_YY,
+		const uint8_t &_daylight_savings, const int8_t &_dut1, const uint8_t &_leap_second_warning)
+	{
+		hour.push_back(_hour);
+		mins.push_back(_mins);
+		doty.push_back(_doty);
+		YY.push_back(_YY);
+		daylight_savings.push_back(_daylight_savings);
+		dut1.push_back(_dut1);
+		leap_second_warning.push_back(_leap_second_warning);
+	}
+
+	void check()
+	{
+		const uint32_t _count = hour.size();
+		std::vector<uint64_t> _simd(_count), _scalar(_count);
+		wwvb_encode_bulk(hour.data(), mins.data(), doty.data(), YY.data(), daylight_savings.data(), dut1.data(),
+			leap_second_warning.data(), _simd.data(), _count);
+		wwvb_encode_bulk_scalar(hour.data(), mins.data(), doty.data(), YY.data(), daylight_savings.data(), dut1.data(),
+			leap_second_warning.data(), _scalar.data(), _count);
+		for (uint32_t i = 0; i < _count; ++i)
+		{
+			CHECK_EQUAL(wwvb_encode_frame(hour[i], mins[i], doty[i], YY[i], daylight_savings[i], dut1[i], leap_second_warning[i]), _scalar[i]);
+			CHECK_EQUAL(_scalar[i], _simd[i]);
+		}
+	}
+};
+
+int main()
+{
+#if defined(__AVX2__)
+	printf("bulk_simd : AVX2, 8 lanes\n");
+#elif defined(__SSE2__)
+	printf("bulk_simd : SSE2, 4 lanes\n");
+#else
+	printf("bulk_simd : scalar only\n");
+#endif
+
+	// every hour and minute
+	bulk_fields _time;
+	for (uint8_t _hour = 0; _hour < 24; ++_hour)
+	{
+		for (uint8_t _mins = 0; _mins < 60; ++_mins)
+		{
+			_time.add(_hour, _mins, 1, 0, 0, 0, 0);
+		}
+	}
+	_time.add(23, 59, 1, 0, 0, 0, 0); // 1441 : not a multiple of the lanes
+	_time.check();
+
+	// every day of every year
+	bulk_fields _date;
+	for (uint8_t _YY = 0; _YY < 100; ++_YY)
+	{
+		for (uint16_t _doty = 1; _doty <= 365 + wwvb_frame_is_leap_year(_YY); ++_doty)
+		{
+			_date.add(12, 30, _doty, _YY, 0, 0, 0);
+		}
+	}
+	_date.check();
+
+	// every DUT1, daylight savings code and leap second warning
+	bulk_fields _misc;
+	for (int8_t _dut1 = -9; _dut1 <= 9; ++_dut1)
+	{
+		for (uint8_t _daylight_savings = 0; _daylight_savings < 4; ++_daylight_savings)
+		{
+			for (uint8_t _leap_second_warning = 0; _leap_second_warning < 2; ++_leap_second_warning)
+			{
+				_misc.add(23, 59, 366, 16, _daylight_savings, _dut1, _leap_second_warning);
+			}
+		}
+	}
+	_misc.check();
+
+	// every out of range DUT1 (clamped to -9 / +9 by every encoder)
+	bulk_fields _dut1;
+	for (int16_t _value = -128; _value <= 127; ++_value)
+	{
+		_dut1.add(18, 42, 258, 8, 3, (int8_t)_value, 0);
+	}
+	_dut1.check();
+	CHECK_EQUAL(wwvb_encode_frame(18, 42, 258, 8, 3, -9), wwvb_encode_frame(18, 42, 258, 8, 3, -128));
+	CHECK_EQUAL(wwvb_encode_frame(18, 42, 258, 8, 3, 9), wwvb_encode_frame(18, 42, 258, 8, 3, 127));
+
+	// pseudo-random fields, and every count up to 2 * 8 lanes (the scalar tail)
+	srand(1);
+	bulk_fields _random;
+	for (uint32_t i = 0; i < 100003; ++i)
+	{
+		const uint8_t _YY = rand() % 100;
+		_random.add(rand() % 24, rand() % 60, 1 + rand() % (365 + wwvb_frame_is_leap_year(_YY)), _YY,
+			rand() % 4, (int8_t)(rand() % 19 - 9), rand() % 2);
+	}
+	_random.check();
+	for (uint8_t n = 0; n <= 16; ++n)
+	{
+		bulk_fields _tail;
+		for (uint8_t i = 0; i < n; ++i)
+		{
+			_tail.add(i, 59 - i, 366 - i, 99 - i, i & 3, (int8_t)(i - 8), i & 1);
+		}
+		_tail.check();
+	}
+
+	// the range encoder, across a year rollover
+	uint64_t _frames[3 * 1440];
+	uint8_t _hour = 0, _mins = 0, _YY = 16;
+	uint16_t _doty = 365;
+	wwvb_encode_frames(_hour, _mins, _doty, _YY, _frames, 3 * 1440, 3, -7, true);
+	for (uint32_t i = 0; i < 3 * 1440; ++i)
+	{
+		CHECK_EQUAL(wwvb_encode_frame(_hour, _mins, _doty, _YY, 3, -7, true), _frames[i]);
+		wwvb_next_minute(_hour, _mins, _doty, _YY);
+	}
+
+	return wwvb_test_result("bulk_simd");
+}
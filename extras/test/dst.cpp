@@ -0,0 +1,156 @@
+/*
+Daylight savings rule test (wwvb_dst.h)
+
+* wwvb_dst_us, wwvb_dst_eu and wwvb_dst_none on the days around each transition, from a table of dates
+  (the Sundays are from a calendar, not from wwvb_nth_day_of_week), including the years the US transitions
+  fall on the 8th of March and the 1st of November and the EU ones on the 25th and 31st
+* wwvb_dst_code with a southern hemisphere rule (begins after it ends)
+* set_time sends WWVB_DST_NO by default, the rule only with WWVB_DST_AUTO
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+
+#define _DEBUG 0
+#define REQUIRE_TIMEDATESTRING 0
+
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+#include <wwvb_dst.h>
+#include "wwvb_test.h"
+
+wwvb wwvb_tx;
+
+// rule, DD/MM/20YY and the code sent that day
+struct dst_case
+{
+	wwvb_dst_rule rule;
+	uint8_t DD, MM, YY;
+	uint8_t code;
+};
+
+const dst_case cases[] = {
+	// US : 2nd Sunday in March to the 1st Sunday in November
+	{ wwvb_dst_us,  1,  1, 15, WWVB_DST_NO },
+	{ wwvb_dst_us,  7,  3, 15, WWVB_DST_NO },
+	{ wwvb_dst_us,  8,  3, 15, WWVB_DST_BEGINS }, // the 8th, the earliest it can be
+	{ wwvb_dst_us,  9,  3, 15, WWVB_DST_YES },
+	{ wwvb_dst_us, 31, 10, 15, WWVB_DST_YES },
+	{ wwvb_dst_us,  1, 11, 15, WWVB_DST_ENDS },   // the 1st, the earliest it can be
+	{ wwvb_dst_us,  2, 11, 15, WWVB_DST_NO },
+	{ wwvb_dst_us, 31, 12, 15, WWVB_DST_NO },
+	{ wwvb_dst_us,  7,  3, 20, WWVB_DST_NO },     // leap year
+	{ wwvb_dst_us,  8,  3, 20, WWVB_DST_BEGINS },
+	{ wwvb_dst_us,  9,  3, 20, WWVB_DST_YES },
+	{ wwvb_dst_us, 31, 10, 20, WWVB_DST_YES },
+	{ wwvb_dst_us,  1, 11, 20, WWVB_DST_ENDS },
+	{ wwvb_dst_us,  2, 11, 20, WWVB_DST_NO },
+	{ wwvb_dst_us,  7,  3, 26, WWVB_DST_NO },
+	{ wwvb_dst_us,  8,  3, 26, WWVB_DST_BEGINS },
+	{ wwvb_dst_us,  9,  3, 26, WWVB_DST_YES },
+	{ wwvb_dst_us, 31, 10, 26, WWVB_DST_YES },
+	{ wwvb_dst_us,  1, 11, 26, WWVB_DST_ENDS },
+	{ wwvb_dst_us,  2, 11, 26, WWVB_DST_NO },
+	{ wwvb_dst_us, 13,  3, 21, WWVB_DST_NO },
+	{ wwvb_dst_us, 14,  3, 21, WWVB_DST_BEGINS }, // the 14th and the 7th, the latest they can be
+	{ wwvb_dst_us, 15,  3, 21, WWVB_DST_YES },
+	{ wwvb_dst_us,  6, 11, 21, WWVB_DST_YES },
+	{ wwvb_dst_us,  7, 11, 21, WWVB_DST_ENDS },
+	{ wwvb_dst_us,  8, 11, 21, WWVB_DST_NO },
+	{ wwvb_dst_us, 12,  3,  0, WWVB_DST_BEGINS }, // 2000, a leap year
+	{ wwvb_dst_us,  5, 11,  0, WWVB_DST_ENDS },
+	// EU : last Sunday in March to the last Sunday in October
+	{ wwvb_dst_eu,  1,  1, 19, WWVB_DST_NO },
+	{ wwvb_dst_eu, 30,  3, 19, WWVB_DST_NO },
+	{ wwvb_dst_eu, 31,  3, 19, WWVB_DST_BEGINS }, // the 31st, the latest it can be
+	{ wwvb_dst_eu,  1,  4, 19, WWVB_DST_YES },
+	{ wwvb_dst_eu, 26, 10, 19, WWVB_DST_YES },
+	{ wwvb_dst_eu, 27, 10, 19, WWVB_DST_ENDS },
+	{ wwvb_dst_eu, 28, 10, 19, WWVB_DST_NO },
+	{ wwvb_dst_eu, 30,  3, 24, WWVB_DST_NO },     // leap year
+	{ wwvb_dst_eu, 31,  3, 24, WWVB_DST_BEGINS },
+	{ wwvb_dst_eu,  1,  4, 24, WWVB_DST_YES },
+	{ wwvb_dst_eu, 24,  3, 18, WWVB_DST_NO },
+	{ wwvb_dst_eu, 25,  3, 18, WWVB_DST_BEGINS }, // the 25th, the earliest it can be
+	{ wwvb_dst_eu, 26,  3, 18, WWVB_DST_YES },
+	{ wwvb_dst_eu, 24, 10, 20, WWVB_DST_YES },
+	{ wwvb_dst_eu, 25, 10, 20, WWVB_DST_ENDS },   // the 25th, leap year
+	{ wwvb_dst_eu, 26, 10, 20, WWVB_DST_NO },
+	{ wwvb_dst_eu, 30, 10, 21, WWVB_DST_YES },
+	{ wwvb_dst_eu, 31, 10, 21, WWVB_DST_ENDS },   // the 31st
+	{ wwvb_dst_eu,  1, 11, 21, WWVB_DST_NO },
+	{ wwvb_dst_eu,  8,  3, 20, WWVB_DST_NO },     // the US transition days
+	{ wwvb_dst_eu,  1, 11, 20, WWVB_DST_NO },
+	// none
+	{ wwvb_dst_none,  8,  3, 20, WWVB_DST_NO },
+	{ wwvb_dst_none, 29,  3, 20, WWVB_DST_NO },
+	{ wwvb_dst_none,  1,  7, 20, WWVB_DST_NO },
+	{ wwvb_dst_none, 25, 10, 20, WWVB_DST_NO },
+	{ wwvb_dst_none,  1, 11, 20, WWVB_DST_NO },
+};
+
+uint16_t doty_of(const uint8_t &_DD, const uint8_t &_MM, const uint8_t &_YY)
+{
+	return to_day_of_the_year<uint8_t>(_DD, _MM, is_leap_year(2000 + _YY));
+}
+
+void test_rules()
+{
+	for (uint8_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i)
+	{
+		const dst_case &_c = cases[i];
+		if (!CHECK_EQUAL(_c.code, _c.rule(_c.YY, doty_of(_c.DD, _c.MM, _c.YY))))
+		{
+			printf("    case %u : %02u/%02u/20%02u\n", i, _c.DD, _c.MM, _c.YY);
+		}
+	}
+}
+
+void test_southern()
+{
+	// begins on day 280, ends on day 95 (of the next year)
+	const uint16_t _doty[8] = { 1, 94, 95, 96, 279, 280, 281, 366 };
+	const uint8_t _code[8] = { WWVB_DST_YES, WWVB_DST_YES, WWVB_DST_ENDS, WWVB_DST_NO,
+		WWVB_DST_NO, WWVB_DST_BEGINS, WWVB_DST_YES, WWVB_DST_YES };
+	for (uint8_t i = 0; i < 8; ++i)
+	{
+		CHECK_EQUAL(_code[i], wwvb_dst_code(_doty[i], 280, 95));
+	}
+}
+
+void test_set_time()
+{
+	wwvb_tx.setDSTRule(wwvb_dst_us);
+
+	// 8/3/2015, US daylight savings begins : the default is a fixed WWVB_DST_NO
+	wwvb_tx.set_time(12, 0, 8, 3, 15);
+	CHECK_EQUAL(WWVB_DST_NO, wwvb_tx.getDSTMode());
+	CHECK_EQUAL(WWVB_DST_NO, wwvb_tx.getDST());
+	wwvb_tx.add_time(24, 0);
+	CHECK_EQUAL(WWVB_DST_NO, wwvb_tx.getDST());
+
+	// the rule is opt-in, and worked out again when the day changes
+	wwvb_tx.set_time(12, 0, 8, 3, 15, WWVB_DST_AUTO);
+	CHECK_EQUAL(WWVB_DST_AUTO, wwvb_tx.getDSTMode());
+	CHECK_EQUAL(WWVB_DST_BEGINS, wwvb_tx.getDST());
+	wwvb_tx.add_time(24, 0);
+	CHECK_EQUAL(WWVB_DST_YES, wwvb_tx.getDST());
+
+	// a fixed code is kept across days
+	wwvb_tx.set_time(12, 0, 1, 11, 15, WWVB_DST_YES);
+	wwvb_tx.add_time(24, 0);
+	CHECK_EQUAL(WWVB_DST_YES, wwvb_tx.getDST());
+}
+
+int main()
+{
+	test_rules();
+	test_southern();
+	test_set_time();
+	return wwvb_test_result("dst");
+}
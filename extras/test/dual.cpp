@@ -0,0 +1,159 @@
+/*
+wwvb_dual.h test
+
+Runs the real wwvb_dual::interrupt_routine() from the simulated Timer1 (host_tick, see extras/host/Arduino.h)
+and decodes both compare outputs (OCR1A : channel 0, OCR1B : channel 1) by their low time
+
+* channel 0 sends the wwvb_encode_frame() frame of its time, with the US daylight savings rule
+* channel 1 sends its own time (a timezone 2 hours behind) and daylight savings code (wwvb_dst_none)
+* calibrate() of one channel moves only the edges of that channel
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+
+#define _DEBUG 0
+#define REQUIRE_TIMEDATESTRING 0
+
+#include <vector>
+#include <TimeDateTools.h> // include before wwvb_dual.h
+#include <wwvb_dual.h>
+#include "wwvb_test.h"
+
+wwvb_dual wwvb_tx;
+
+ISR(TIMER1_OVF_vect)
+{
+	wwvb_tx.interrupt_routine();
+}
+
+// 12:00 UTC 13/3/2016 (doty 73, daylight savings begins today), channel 1 two hours behind with no daylight savings
+void start(const int16_t &_cal0, const int16_t &_cal1)
+{
+	wwvb_tx.channel[0].setTimezone(0, 0);
+	wwvb_tx.channel[1].setTimezone(-2, 0);
+	wwvb_tx.channel[1].setDSTRule(wwvb_dst_none);
+	wwvb_tx.setup();
+	wwvb_tx.channel[0].calibrate(_cal0, _cal0);
+	wwvb_tx.channel[1].calibrate(_cal1, _cal1);
+	wwvb_tx.set_time(12, 0, 13, 3, 16, WWVB_DST_AUTO);
+	wwvb_tx.start();
+}
+
+uint16_t output(const uint8_t &_channel)
+{
+	return (_channel == 0) ? OCR1A : OCR1B;
+}
+
+// the symbols of the first _count bits of both channels, from the low time of each bit
+void decode(std::vector<uint8_t> *_symbols, const uint8_t &_count)
+{
+	uint32_t _low[2] = { 0, 0 };
+	while ((_symbols[0].size() < _count) | (_symbols[1].size() < _count))
+	{
+		host_tick();
+		for (uint8_t c = 0; c < 2; ++c)
+		{
+			if (output(c) == 6) // PWM_LOW
+			{
+				++_low[c];
+			}
+			else if (_low[c] > 0)
+			{
+				// 12030, 30075 or 48120 ticks
+				_symbols[c].push_back((_low[c] < 20000) ? 0 : ((_low[c] < 40000) ? 1 : 2));
+				_low[c] = 0;
+			}
+		}
+	}
+}
+
+// the tick of every change of the channel outputs in the first _ticks ticks
+void edges(std::vector<uint32_t> *_edges, const uint32_t &_ticks)
+{
+	uint16_t _last[2] = { output(0), output(1) };
+	for (uint32_t t = 0; t < _ticks; ++t)
+	{
+		host_tick();
+		for (uint8_t c = 0; c < 2; ++c)
+		{
+			if (output(c) != _last[c])
+			{
+				_last[c] = output(c);
+				_edges[c].push_back(t);
+			}
+		}
+	}
+}
+
+void test_frames()
+{
+	start(0, 0);
+	const uint64_t _frame[2] = { wwvb_encode_frame(12, 0, 73, 16, WWVB_DST_BEGINS), wwvb_encode_frame(10, 0, 73, 16, WWVB_DST_NO) };
+	CHECK_EQUAL(_frame[0], wwvb_tx.channel[0].frame());
+	CHECK_EQUAL(_frame[1], wwvb_tx.channel[1].frame());
+	CHECK_EQUAL(WWVB_DST_BEGINS, wwvb_tx.channel[0].getDST());
+	CHECK_EQUAL(WWVB_DST_NO, wwvb_tx.channel[1].getDST());
+
+	std::vector<uint8_t> _symbols[2];
+	decode(_symbols, 60);
+	for (uint8_t c = 0; c < 2; ++c)
+	{
+		for (uint8_t i = 0; i < 60; ++i)
+		{
+			CHECK_EQUAL(wwvb_frame_symbol(_frame[c], i), _symbols[c][i]);
+		}
+	}
+
+	// the minute changes on both channels at the end of bit 59
+	CHECK_EQUAL(0, wwvb_tx.channel[0].mm());
+	while ((wwvb_tx.frame_index[0] != 0) | (wwvb_tx.frame_index[1] != 0))
+	{
+		host_tick();
+	}
+	wwvb_tx.stop();
+	CHECK_EQUAL(1, wwvb_tx.channel[0].mm());
+	CHECK_EQUAL(12, wwvb_tx.channel[0].hh());
+	CHECK_EQUAL(1, wwvb_tx.channel[1].mm());
+	CHECK_EQUAL(10, wwvb_tx.channel[1].hh());
+}
+
+void test_calibrate()
+{
+	// 3 bits
+	const uint32_t _ticks = 3 * 60151 + 100;
+	std::vector<uint32_t> _base[2], _slow0[2], _slow1[2];
+	start(0, 0);
+	edges(_base, _ticks);
+	start(3000, 0);
+	edges(_slow0, _ticks);
+	start(0, 3000);
+	edges(_slow1, _ticks);
+	wwvb_tx.stop();
+
+	// a 3000 tick longer bit moves the edges of that channel only
+	CHECK(_slow0[0] != _base[0]);
+	CHECK(_slow0[1] == _base[1]);
+	CHECK(_slow1[0] == _base[0]);
+	CHECK(_slow1[1] != _base[1]);
+	CHECK(_base[0].size() >= 5);
+	CHECK(_slow0[0].size() >= 3);
+	if (_slow0[0].size() >= 3)
+	{
+		CHECK_EQUAL(_base[0][1] + 3000, _slow0[0][1]);
+	}
+}
+
+int main()
+{
+	sei();
+	test_frames();
+	test_calibrate();
+	return wwvb_test_result("dual");
+}
@@ -0,0 +1,234 @@
+/*
+Golden vector test of the packed frame encoder (wwvb_frame.h) and the transmitter (wwvb::frame())
+
+For every day from 1 Jan 2000 to 31 Dec 2099 the frame is worked out three ways and compared:
+* reference         : set bit by bit from the NIST second / weight table below (independent of wwvb_frame.h)
+* wwvb_encode_frame : the packed encoder
+* wwvb::frame()     : the transmitter after set_time()
+The daylight savings code cycles through 0 - 3 (fixed codes), and the hour and minute change from day to day.
+
+Then the leap year days, the US daylight savings rule (WWVB_DST_AUTO) on known transition days,
+DUT1, the leap second warning, and a few literal frames
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+
+#define _DEBUG 0
+#define REQUIRE_TIMEDATESTRING 0
+
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+#include <wwvb_frame.h>
+#include <wwvb_dst.h>
+#include "wwvb_test.h"
+
+// second, weight : the NIST WWVB time code (BCD, most significant bit first)
+struct nist_bit
+{
+	uint8_t second;
+	uint16_t weight;
+};
+const nist_bit nist_mins[] = { { 1, 40 }, { 2, 20 }, { 3, 10 }, { 5, 8 }, { 6, 4 }, { 7, 2 }, { 8, 1 } };
+const nist_bit nist_hour[] = { { 12, 20 }, { 13, 10 }, { 15, 8 }, { 16, 4 }, { 17, 2 }, { 18, 1 } };
+const nist_bit nist_doty[] = { { 22, 200 }, { 23, 100 }, { 25, 80 }, { 26, 40 }, { 27, 20 }, { 28, 10 },
+	{ 30, 8 }, { 31, 4 }, { 32, 2 }, { 33, 1 } };
+const nist_bit nist_dut1[] = { { 40, 8 }, { 41, 4 }, { 42, 2 }, { 43, 1 } };
+const nist_bit nist_year[] = { { 45, 80 }, { 46, 40 }, { 47, 20 }, { 48, 10 }, { 50, 8 }, { 51, 4 }, { 52, 2 }, { 53, 1 } };
+
+uint64_t nist_field(const nist_bit *_bits, const uint8_t &_n, uint16_t _value)
+{
+	uint64_t _frame = 0;
+	for (uint8_t i = 0; i < _n; ++i)
+	{
+		if (_value >= _bits[i].weight)
+		{
+			_value -= _bits[i].weight;
+			_frame |= 1ULL << _bits[i].second;
+		}
+	}
+	return _frame;
+}
+
+#define NIST_FIELD(bits, value) nist_field(bits, sizeof(bits) / sizeof(bits[0]), value)
+
+uint64_t reference_frame(const uint8_t &_hour, const uint8_t &_mins, const uint16_t &_doty, const uint8_t &_YY,
+	const uint8_t &_dst, const int8_t &_dut1, const bool &_lsw)
+{
+	uint64_t _frame = NIST_FIELD(nist_mins, _mins) | NIST_FIELD(nist_hour, _hour) | NIST_FIELD(nist_doty, _doty)
+		| NIST_FIELD(nist_year, _YY) | NIST_FIELD(nist_dut1, (_dut1 < 0) ? -_dut1 : _dut1);
+	_frame |= (_dut1 < 0) ? (1ULL << 37) : ((1ULL << 36) | (1ULL << 38));   // DUT1 sign : + - +
+	_frame |= (uint64_t)(is_leap_year(2000 + _YY)) << 55;                // leap year indicator
+	_frame |= (uint64_t)_lsw << 56;                                      // leap second warning
+	_frame |= ((uint64_t)(_dst >> 1) << 57) | ((uint64_t)(_dst & 1) << 58); // daylight savings
+	return _frame;
+}
+
+wwvb wwvb_tx;
+
+// set the transmitter to hh:mm on day _doty of 20_YY, with a fixed daylight savings code (or WWVB_DST_AUTO)
+void set_time(const uint8_t &_hour, const uint8_t &_mins, const uint16_t &_doty, const uint8_t &_YY, const uint8_t &_dst)
+{
+	uint8_t _DD, _MM;
+	from_day_of_the_year<uint8_t>(_doty, _DD, _MM, is_leap_year(2000 + _YY));
+	wwvb_tx.set_time(_hour, _mins, _DD, _MM, _YY, _dst);
+}
+
+void every_day()
+{
+	uint32_t _days = 0;
+	for (uint8_t _YY = 0; _YY < 100; ++_YY)
+	{
+		const uint16_t _days_in_year = 365 + is_leap_year(2000 + _YY);
+		for (uint16_t _doty = 1; _doty <= _days_in_year; ++_doty, ++_days)
+		{
+			const uint8_t _hour = _days % 24;
+			const uint8_t _mins = (_days * 7) % 60;
+			const uint8_t _dst = _days & 0x03;
+
+			const uint64_t _reference = reference_frame(_hour, _mins, _doty, _YY, _dst, 0, false);
+			CHECK_EQUAL(_reference, wwvb_encode_frame(_hour, _mins, _doty, _YY, _dst));
+
+			set_time(_hour, _mins, _doty, _YY, _dst);
+			CHECK_EQUAL(_reference, wwvb_tx.frame());
+		}
+	}
+	CHECK(_days == 36525);
+}
+
+void leap_years()
+{
+	// the last day of each year : 366 in a leap year (2000 is a leap year, every 4th year to 2096)
+	for (uint8_t _YY = 0; _YY < 100; ++_YY)
+	{
+		const bool _is_leap_year = (_YY % 4) == 0;
+		CHECK(wwvb_frame_is_leap_year(_YY) == _is_leap_year);
+		const uint16_t _last = 365 + _is_leap_year;
+
+		set_time(23, 59, _last, _YY, WWVB_DST_NO);
+		CHECK(wwvb_tx.DD() == 31);
+		CHECK(wwvb_tx.MM() == 12);
+		CHECK_EQUAL(reference_frame(23, 59, _last, _YY, 0, 0, false), wwvb_tx.frame());
+		CHECK(((wwvb_tx.frame() >> 55) & 1) == _is_leap_year);
+
+		// 29 Feb / 1 Mar
+		wwvb_tx.set_time(12, 0, _is_leap_year ? 29 : 28, 2, _YY, WWVB_DST_NO);
+		CHECK_EQUAL(reference_frame(12, 0, 59 + _is_leap_year, _YY, 0, 0, false), wwvb_tx.frame());
+		wwvb_tx.set_time(12, 0, 1, 3, _YY, WWVB_DST_NO);
+		CHECK_EQUAL(reference_frame(12, 0, 60 + _is_leap_year, _YY, 0, 0, false), wwvb_tx.frame());
+	}
+}
+
+// US daylight savings (WWVB_DST_AUTO) : 2nd Sunday in March to the 1st Sunday in November
+void daylight_savings()
+{
+	// 20YY, day DST begins, day DST ends
+	const uint16_t transitions[][3] = {
+		{ 7, 70, 308 },  // 11 Mar 2007, 4 Nov 2007
+		{ 16, 73, 311 }, // 13 Mar 2016, 6 Nov 2016 (leap year)
+		{ 20, 68, 306 }, // 8 Mar 2020, 1 Nov 2020 (leap year)
+		{ 24, 70, 308 }, // 10 Mar 2024, 3 Nov 2024 (leap year)
+		{ 25, 68, 306 }, // 9 Mar 2025, 2 Nov 2025
+	};
+	wwvb_tx.setDSTRule(wwvb_dst_us);
+	for (uint8_t t = 0; t < sizeof(transitions) / sizeof(transitions[0]); ++t)
+	{
+		const uint8_t _YY = transitions[t][0];
+		const uint16_t _begin = transitions[t][1], _end = transitions[t][2];
+		const uint16_t _doty[6] = { 1, (uint16_t)(_begin - 1), _begin, (uint16_t)(_begin + 1), _end, (uint16_t)(_end + 1) };
+		const uint8_t _expected[6] = { WWVB_DST_NO, WWVB_DST_NO, WWVB_DST_BEGINS, WWVB_DST_YES, WWVB_DST_ENDS, WWVB_DST_NO };
+		for (uint8_t i = 0; i < 6; ++i)
+		{
+			CHECK(wwvb_dst_us(_YY, _doty[i]) == _expected[i]);
+			set_time(12, 30, _doty[i], _YY, WWVB_DST_AUTO);
+			CHECK(wwvb_tx.getDST() == _expected[i]);
+			CHECK_EQUAL(reference_frame(12, 30, _doty[i], _YY, _expected[i], 0, false), wwvb_tx.frame());
+		}
+	}
+
+	// the code is worked out per UTC day, so it stays the same all day
+	set_time(0, 0, 73, 16, WWVB_DST_AUTO);
+	for (uint16_t m = 0; m < 24 * 60; ++m)
+	{
+		CHECK(wwvb_tx.getDST() == WWVB_DST_BEGINS);
+		wwvb_tx.add_time(0, 1);
+	}
+	CHECK(wwvb_tx.getDST() == WWVB_DST_YES); // 14 Mar 2016
+}
+
+void dut1_and_leap_second()
+{
+	for (int8_t _dut1 = -9; _dut1 <= 9; ++_dut1)
+	{
+		CHECK_EQUAL(reference_frame(18, 42, 258, 8, 3, _dut1, false), wwvb_encode_frame(18, 42, 258, 8, 3, _dut1));
+		wwvb_tx.setDUT1(_dut1);
+		set_time(18, 42, 258, 8, WWVB_DST_YES);
+		CHECK_EQUAL(reference_frame(18, 42, 258, 8, 3, _dut1, false), wwvb_tx.frame());
+	}
+	wwvb_tx.setDUT1(0);
+
+	// out of range DUT1 : the encoders clamp to -9 / +9 (-128 cant be negated), the setters reject it
+	const int8_t _out_of_range[6] = { -128, -100, -10, 10, 100, 127 };
+	for (uint8_t i = 0; i < 6; ++i)
+	{
+		const int8_t _clamped = (_out_of_range[i] < 0) ? -9 : 9;
+		CHECK_EQUAL(reference_frame(18, 42, 258, 8, 3, _clamped, false), wwvb_encode_frame(18, 42, 258, 8, 3, _out_of_range[i]));
+		CHECK(!wwvb_tx.setDUT1(_out_of_range[i]));
+		const wwvb_dut1_step _steps[2] = { { 8, 1, 5 }, { 8, 200, _out_of_range[i] } };
+		CHECK(!wwvb_tx.setDUT1Schedule(_steps, 2));
+		set_time(18, 42, 258, 8, WWVB_DST_YES);
+		CHECK_EQUAL(reference_frame(18, 42, 258, 8, 3, 0, false), wwvb_tx.frame());
+	}
+	CHECK(wwvb_tx.setDUT1(-9));
+	CHECK(wwvb_tx.setDUT1(9));
+	const wwvb_dut1_step _steps[2] = { { 8, 1, -9 }, { 8, 200, 9 } };
+	CHECK(wwvb_tx.setDUT1Schedule(_steps, 2));
+	set_time(18, 42, 258, 8, WWVB_DST_YES);
+	CHECK_EQUAL(reference_frame(18, 42, 258, 8, 3, 9, false), wwvb_tx.frame());
+	wwvb_tx.setDUT1Schedule(0, 0);
+	wwvb_tx.setDUT1(0);
+
+	// leap second at the end of 31 Dec 2016 : the warning is sent all of December
+	const wwvb_leap_second _leap_seconds[1] = { { 16, 12 } };
+	wwvb_tx.setLeapSecondSchedule(_leap_seconds, 1);
+	set_time(0, 0, 335, 16, WWVB_DST_AUTO); // 30 Nov
+	CHECK_EQUAL(reference_frame(0, 0, 335, 16, 0, 0, false), wwvb_tx.frame());
+	set_time(0, 0, 336, 16, WWVB_DST_AUTO); // 1 Dec
+	CHECK_EQUAL(reference_frame(0, 0, 336, 16, 0, 0, true), wwvb_tx.frame());
+	CHECK_EQUAL(reference_frame(0, 0, 336, 16, 0, 0, true), wwvb_encode_frame(0, 0, 336, 16, 0, 0, true));
+	set_time(23, 59, 366, 16, WWVB_DST_AUTO); // 23:59 31 Dec, 61 seconds
+	CHECK(wwvb_tx.frame_length() == 61);
+	CHECK_EQUAL(reference_frame(23, 59, 366, 16, 0, 0, true), wwvb_tx.frame());
+	set_time(0, 0, 1, 17, WWVB_DST_AUTO);
+	CHECK(wwvb_tx.frame_length() == 60);
+	CHECK_EQUAL(reference_frame(0, 0, 1, 17, 0, 0, false), wwvb_tx.frame());
+	wwvb_tx.setLeapSecondSchedule(0, 0);
+}
+
+// literal frames (bit n = second n), worked out by hand from the NIST table
+void literal_frames()
+{
+	// 00:00 1 Jan 2000, DUT1 +0.0 : DOTY 1 (33), DUT1 + + (36 38), leap year (55)
+	CHECK_EQUAL(0x0080005200000000ULL, wwvb_encode_frame(0, 0, 1, 0));
+	// 23:59 31 Dec 2099 (day 365) : MINS 40 10 8 1 (1 3 5 8), HOUR 20 2 1 (12 17 18), DOTY 200 100 40 20 4 1 (22 23 26 27 31 33),
+	// DUT1 + + (36 38), YEAR 80 10 8 1 (45 48 50 53)
+	CHECK_EQUAL(0x002520528CC6112AULL, wwvb_encode_frame(23, 59, 365, 99));
+	// 18:42 day 258 2008, DUT1 -0.3, DST in effect, leap second warning :
+	// MINS 40 2 (1 7), HOUR 10 8 (13 15), DOTY 200 40 10 8 (22 26 28 30), DUT1 - (37) 0.2 0.1 (42 43), YEAR 8 (50), LYI LSW (55 56), DST 11 (57 58)
+	CHECK_EQUAL(0x07840C205440A082ULL, wwvb_encode_frame(18, 42, 258, 8, 3, -3, true));
+}
+
+int main()
+{
+	every_day();
+	leap_years();
+	daylight_savings();
+	dut1_and_leap_second();
+	literal_frames();
+	return wwvb_test_result("frame_golden");
+}
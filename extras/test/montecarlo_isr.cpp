@@ -0,0 +1,153 @@
+/*
+wwvb_montecarlo.h tick model vs the real interrupt routine (extras/host/wwvb_montecarlo_isr.h)
+
+* no crystal error, lost ticks or latency : the frame period error, frames, lock and time to lock are the same
+  for calibrate() values either side of the receiver period tolerance, and a PWM_LOW the receiver cant hear
+* the real isr driver is repeatable (same seed, same result)
+* the modulation depth of both comes from the PWM_HIGH in the config : too low to hear, neither locks
+* lost ticks lengthen the frames by the same mean as the model (within the spread of a few trials)
+* isr latency only moves the edges : the mean frame error stays within the latency
+* 1 thread and 3 threads give the same results (sums, maximum and histogram), for both drivers
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+
+#define _DEBUG 0
+#define REQUIRE_TIMEDATESTRING 0
+
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+#include <wwvb_montecarlo_isr.h>
+#include "wwvb_test.h"
+
+const wwvb_mc_config ideal = { 16000000, { 12030, 30075, 48120 }, 60150, 66, 0.0f, 0.0f, 0, 3, WWVB_RX_TYPICAL };
+
+#define POINTS 4
+const wwvb_mc_point grid[POINTS] = {
+	{ 86, 133, 6 },   // the ATmega328P calibration
+	{ 0, 133, 6 },    // 1.0014s bits
+	{ -300, 133, 6 }, // 0.9964s bits
+	{ 86, 133, 60 },  // too little depth to hear
+};
+
+bool close(const double &_a, const double &_b, const double &_tolerance)
+{
+	return fabs(_a - _b) <= _tolerance;
+}
+
+void test_ideal()
+{
+	wwvb_mc_result _model[POINTS], _isr[POINTS], _again[POINTS];
+	wwvb_montecarlo(ideal, grid, POINTS, 2, _model, 1);
+	wwvb_montecarlo_isr(ideal, grid, POINTS, 2, _isr);
+	wwvb_montecarlo_isr(ideal, grid, POINTS, 2, _again);
+	for (uint8_t p = 0; p < POINTS; ++p)
+	{
+		CHECK_EQUAL(_model[p].trials, _isr[p].trials);
+		CHECK_EQUAL(_model[p].frames, _isr[p].frames);
+		CHECK_EQUAL(_model[p].locked, _isr[p].locked);
+		CHECK_EQUAL(_model[p].lock_seconds, _isr[p].lock_seconds);
+		CHECK(close(_model[p].mean_us(), _isr[p].mean_us(), 0.01));
+		CHECK(close(_model[p].frame_error_max_us, _isr[p].frame_error_max_us, 0.01));
+
+		CHECK_EQUAL(_isr[p].locked, _again[p].locked);
+		CHECK(_isr[p].frame_error_us == _again[p].frame_error_us);
+	}
+	CHECK_EQUAL(2, _isr[0].locked);
+	CHECK_EQUAL(0, _isr[3].locked);
+}
+
+void test_pwm_high()
+{
+	// PWM_HIGH 12, PWM_LOW 6 : ~6dB, under the 10dB of a typical receiver
+	wwvb_mc_config _cfg = ideal;
+	_cfg.pwm_high = 12;
+	wwvb_mc_result _model, _isr;
+	wwvb_montecarlo(_cfg, grid, 1, 2, &_model, 1);
+	wwvb_montecarlo_isr(_cfg, grid, 1, 2, &_isr);
+	CHECK_EQUAL(0, _model.locked);
+	CHECK_EQUAL(0, _isr.locked);
+}
+
+void test_lost_ticks()
+{
+	// ~6 lost overflows a bit, ~6ms a frame
+	wwvb_mc_config _cfg = ideal;
+	_cfg.lost_tick_ppm = 100;
+	_cfg.frames = 2;
+	wwvb_mc_result _base, _model, _isr;
+	wwvb_montecarlo(ideal, grid, 1, 1, &_base, 1);
+	wwvb_montecarlo(_cfg, grid, 1, 4, &_model, 1);
+	wwvb_montecarlo_isr(_cfg, grid, 1, 4, &_isr);
+
+	// 60 bits of 60237 ticks, 16.625us a tick
+	const double _expected_us = 60 * (ideal.endofbit + 86 + 1) * 1e-4 * (2 * 133 / 16.0);
+	CHECK(close(_model.mean_us() - _base.mean_us(), _expected_us, 0.2 * _expected_us));
+	CHECK(close(_isr.mean_us() - _base.mean_us(), _expected_us, 0.2 * _expected_us));
+}
+
+void test_latency()
+{
+	// up to 100us of isr latency
+	wwvb_mc_config _cfg = ideal;
+	_cfg.latency_cycles = 1600;
+	_cfg.frames = 2;
+	wwvb_mc_result _ideal, _isr;
+	wwvb_montecarlo_isr(ideal, grid, 1, 2, &_ideal);
+	wwvb_montecarlo_isr(_cfg, grid, 1, 2, &_isr);
+	CHECK(close(_ideal.mean_us(), _isr.mean_us(), 100));
+	CHECK(_isr.frame_error_max_us <= _ideal.frame_error_max_us + 100);
+}
+
+// every count, sum and histogram bin is the same
+void check_same(const wwvb_mc_result &_a, const wwvb_mc_result &_b)
+{
+	CHECK_EQUAL(_a.trials, _b.trials);
+	CHECK_EQUAL(_a.frames, _b.frames);
+	CHECK_EQUAL(_a.locked, _b.locked);
+	CHECK_EQUAL(_a.lock_seconds, _b.lock_seconds);
+	CHECK(_a.frame_error_us == _b.frame_error_us);
+	CHECK(_a.frame_error2_us == _b.frame_error2_us);
+	CHECK(_a.frame_error_max_us == _b.frame_error_max_us);
+	for (uint8_t i = 0; i < WWVB_MC_BINS; ++i)
+	{
+		CHECK_EQUAL(_a.histogram[i], _b.histogram[i]);
+	}
+}
+
+void test_threads()
+{
+	// crystal error, lost ticks and latency, 18 trials a point (a full and a part chunk)
+	wwvb_mc_config _cfg = ideal;
+	_cfg.crystal_ppm = 20.0f;
+	_cfg.lost_tick_ppm = 10.0f;
+	_cfg.latency_cycles = 200;
+	_cfg.frames = 1;
+	wwvb_mc_result _isr_1[2], _isr_3[2], _model_1[2], _model_3[2];
+	wwvb_montecarlo_isr(_cfg, grid + 1, 2, 18, _isr_1, 1);
+	wwvb_montecarlo_isr(_cfg, grid + 1, 2, 18, _isr_3, 3);
+	wwvb_montecarlo(_cfg, grid + 1, 2, 18, _model_1, 1);
+	wwvb_montecarlo(_cfg, grid + 1, 2, 18, _model_3, 3);
+	for (uint8_t p = 0; p < 2; ++p)
+	{
+		CHECK_EQUAL(18, _isr_3[p].trials);
+		check_same(_isr_1[p], _isr_3[p]);
+		check_same(_model_1[p], _model_3[p]);
+	}
+}
+
+int main()
+{
+	test_ideal();
+	test_pwm_high();
+	test_lost_ticks();
+	test_latency();
+	test_threads();
+	return wwvb_test_result("montecarlo_isr");
+}
@@ -0,0 +1,96 @@
+/*
+wwvb_receiver.h test
+
+* consecutive frames lock a typical receiver (2 good frames)
+* the day and year roll over at 00:00 after 23:59, also through a leap second (61 bit frame)
+* a frame that decodes as 00:00 without a 23:59 before it (e.g. corrupted) breaks the sequence,
+  as does 00:00 on the 1st of January after 23:59 on a day that isnt the last of the year
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <wwvb_frame.h>
+#include <wwvb_receiver.h>
+#include "wwvb_test.h"
+
+// an ideal bit of symbol _symbol (0, 1, 2 : marker)
+void send_bit(wwvb_receiver &_rx, const uint8_t &_symbol)
+{
+	const uint32_t _low_us[3] = { 200000UL, 500000UL, 800000UL };
+	_rx.pulse(_low_us[_symbol], 1000000UL);
+}
+
+void send_frame(wwvb_receiver &_rx, const uint8_t &_hour, const uint8_t &_mins, const uint16_t &_doty, const uint8_t &_YY,
+	const bool &_is_leap_minute = false)
+{
+	const uint64_t _frame = wwvb_encode_frame(_hour, _mins, _doty, _YY);
+	for (uint8_t i = 0; i < 60; ++i)
+	{
+		send_bit(_rx, wwvb_frame_symbol(_frame, i));
+	}
+	if (_is_leap_minute)
+	{
+		send_bit(_rx, 2);
+	}
+}
+
+// good frames in a row after _hour:_mins _doty/_YY then _next_hour:_next_mins _next_doty/_next_YY
+uint8_t frames(const uint8_t &_hour, const uint8_t &_mins, const uint16_t &_doty, const uint8_t &_YY,
+	const uint8_t &_next_hour, const uint8_t &_next_mins, const uint16_t &_next_doty, const uint8_t &_next_YY,
+	const bool &_is_leap_minute = false)
+{
+	wwvb_receiver _rx(WWVB_RX_TYPICAL);
+	send_bit(_rx, 2); // the marker at 59 before the first frame
+	send_frame(_rx, _hour, _mins, _doty, _YY, _is_leap_minute);
+	send_frame(_rx, _next_hour, _next_mins, _next_doty, _next_YY);
+	return _rx.frames();
+}
+
+void test_lock()
+{
+	wwvb_receiver _rx(WWVB_RX_TYPICAL);
+	send_bit(_rx, 2);
+	send_frame(_rx, 12, 34, 73, 16);
+	CHECK(!_rx.locked());
+	send_frame(_rx, 12, 35, 73, 16);
+	CHECK(_rx.locked());
+	CHECK_EQUAL(121, _rx.time_to_lock()); // the marker before the first frame, then 2 frames
+	CHECK((_rx.hh() == 12) & (_rx.mm() == 35) & (_rx.doty() == 73) & (_rx.YY() == 16));
+}
+
+void test_sequence()
+{
+	CHECK_EQUAL(2, frames(12, 34, 73, 16, 12, 35, 73, 16));
+	CHECK_EQUAL(2, frames(12, 59, 73, 16, 13, 0, 73, 16));
+	CHECK_EQUAL(1, frames(12, 34, 73, 16, 12, 36, 73, 16));
+
+	// the day and year roll over
+	CHECK_EQUAL(2, frames(23, 59, 73, 16, 0, 0, 74, 16));
+	CHECK_EQUAL(2, frames(23, 59, 366, 16, 0, 0, 1, 17));
+	CHECK_EQUAL(2, frames(23, 59, 365, 17, 0, 0, 1, 18));
+	CHECK_EQUAL(2, frames(23, 59, 365, 99, 0, 0, 1, 0));
+
+	// through the leap second at the end of 2016
+	CHECK_EQUAL(2, frames(23, 59, 366, 16, 0, 0, 1, 17, true));
+	CHECK_EQUAL(2, frames(23, 59, 181, 15, 0, 0, 182, 15, true));
+
+	// 00:00 out of sequence
+	CHECK_EQUAL(1, frames(12, 34, 73, 16, 0, 0, 74, 16));
+	CHECK_EQUAL(1, frames(12, 34, 73, 16, 0, 0, 1, 17));
+	CHECK_EQUAL(1, frames(23, 58, 366, 16, 0, 0, 1, 17));
+	CHECK_EQUAL(1, frames(23, 59, 200, 16, 0, 0, 1, 17));
+	CHECK_EQUAL(1, frames(23, 59, 365, 16, 0, 0, 1, 17)); // 2016 has 366 days
+	CHECK_EQUAL(1, frames(23, 59, 366, 16, 0, 0, 1, 18));
+	CHECK_EQUAL(1, frames(23, 59, 73, 16, 0, 0, 75, 16));
+}
+
+int main()
+{
+	test_lock();
+	test_sequence();
+	return wwvb_test_result("receiver");
+}
@@ -0,0 +1,202 @@
+/*
+wwvb_render.h test
+
+The renderer runs the real wwvb::interrupt_routine(), so this checks what the library sends, as a waveform
+* duty 0 (PWM_LOW = 0) : the carrier is off (the output is held low), not always high
+* duty ICR1             : the output is held high
+* the rendered PWM output, demodulated by its envelope (the fraction of high samples per ms) and pulse widths,
+  gives the frames back : the 61 bit leap second frame of 23:59 31/12/2016 (DUT1 -0.4s from setDUT1(), the leap
+  second from setLeapSecondSchedule()) and the 60 bit 00:00 1/1/2017 frame after it
+* the daylight savings bits are the ones of the wwvb rule (setDSTRule), on the day daylight savings begins
+* a calibrate() change shows up in the rendered bit length
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+
+#define _DEBUG 0
+#define REQUIRE_TIMEDATESTRING 0
+
+#include <vector>
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+#include <wwvb_render.h>
+#include "wwvb_test.h"
+
+wwvb wwvb_tx;
+
+const wwvb_render_config config_240kHz = { 240000, 0.0f, 60000 };
+const wwvb_leap_second leap_2016[1] = { { 16, 12 } };
+
+// set up and start wwvb_tx at _hour:_mins _DD/_MM/20_YY (UTC) with the daylight savings rule, and no calibration
+// (60151 carrier periods a bit)
+void start(const uint8_t &_hour, const uint8_t &_mins, const uint8_t &_DD, const uint8_t &_MM, const uint8_t &_YY)
+{
+	wwvb_tx.setup();
+	wwvb_tx.calibrate(0, 0);
+	wwvb_tx.set_time(_hour, _mins, _DD, _MM, _YY, WWVB_DST_AUTO);
+	wwvb_tx.start();
+}
+
+// every sample of the next _n is _level
+bool all_samples(wwvb_render &_render, const uint32_t &_n, const int16_t &_level)
+{
+	std::vector<int16_t> _samples(_n);
+	_render.render(_samples.data(), _n);
+	for (uint32_t k = 0; k < _n; ++k)
+	{
+		if (_samples[k] != _level) { return false; }
+	}
+	return true;
+}
+
+void test_duty()
+{
+	// the first 0.8s is the start of frame marker (low), then high
+	start(0, 0, 1, 1, 17);
+	wwvb_tx.setPWM_LOW(0);
+	wwvb_tx.start();
+	wwvb_render _off(wwvb_tx, config_240kHz);
+	CHECK(all_samples(_off, 190000, -32767));
+
+	start(0, 0, 1, 1, 17);
+	wwvb_tx.setPWM_HIGH(ICR1);
+	wwvb_render _on(wwvb_tx, config_240kHz);
+	_on.render(std::vector<int16_t>(195000).data(), 195000);
+	CHECK(all_samples(_on, 40000, 32767));
+}
+
+// a demodulated bit : symbol (0, 1, 2 : marker) and length (ms)
+struct rendered_bit
+{
+	uint8_t symbol;
+	uint32_t ms;
+};
+
+// the next _count bits, from the low time of each bit (the length of a bit is filled in when the next one starts)
+std::vector<rendered_bit> demodulate(wwvb_render &_render, const uint32_t &_count)
+{
+	const uint32_t _per_ms = config_240kHz.sample_rate / 1000;
+	std::vector<int16_t> _samples(_per_ms);
+	std::vector<rendered_bit> _bits;
+	uint32_t _low_ms = 0, _bit_ms = 0;
+	bool _was_high = false;
+	while (_bits.size() < _count)
+	{
+		_render.render(_samples.data(), _per_ms);
+		uint32_t _high = 0;
+		for (uint32_t k = 0; k < _per_ms; ++k)
+		{
+			_high += (_samples[k] > 0);
+		}
+		// ~5% duty cycle for low, ~50% for high
+		const bool _is_high = (_high * 4 > _per_ms);
+		if (!_is_high & _was_high)
+		{
+			// the start of the next bit
+			if (!_bits.empty()) { _bits.back().ms = _bit_ms; }
+			_bit_ms = 0;
+		}
+		++_bit_ms;
+		if (!_is_high)
+		{
+			++_low_ms;
+		}
+		else if (!_was_high)
+		{
+			_bits.push_back({ (uint8_t)((_low_ms < 350) ? 0 : ((_low_ms < 650) ? 1 : 2)), 0 });
+			_low_ms = 0;
+		}
+		_was_high = _is_high;
+	}
+	return _bits;
+}
+
+void test_leap_second()
+{
+	start(23, 59, 31, 12, 16);
+	CHECK(!wwvb_tx.setDUT1(-10));
+	CHECK(wwvb_tx.setDUT1(-4));
+	wwvb_tx.setLeapSecondSchedule(leap_2016, 1);
+	wwvb_tx.set_time(23, 59, 31, 12, 16);
+	wwvb_tx.start();
+	wwvb_render _render(wwvb_tx, config_240kHz);
+
+	const uint64_t _leap_frame = wwvb_encode_frame(23, 59, 366, 16, 0, -4, true);
+	CHECK_EQUAL(_leap_frame, wwvb_tx.frame());
+	CHECK_EQUAL(61, wwvb_tx.frame_length());
+
+	std::vector<uint8_t> _expected;
+	for (uint8_t i = 0; i < 59; ++i)
+	{
+		_expected.push_back(wwvb_frame_symbol(_leap_frame, i));
+	}
+	_expected.push_back(0); // 23:59:59
+	_expected.push_back(2); // 23:59:60
+	const uint64_t _next_frame = wwvb_encode_frame(0, 0, 1, 17, 0, -4, false);
+	for (uint8_t i = 0; i < 60; ++i)
+	{
+		_expected.push_back(wwvb_frame_symbol(_next_frame, i));
+	}
+
+	const std::vector<rendered_bit> _bits = demodulate(_render, _expected.size());
+	for (size_t i = 0; i < _expected.size(); ++i)
+	{
+		CHECK_EQUAL(_expected[i], _bits[i].symbol);
+	}
+	CHECK_EQUAL(60, wwvb_tx.frame_length());
+	wwvb_tx.setLeapSecondSchedule(0, 0);
+	wwvb_tx.setDUT1(0);
+}
+
+void test_dst()
+{
+	// 13/3/2016, daylight savings begins today (US rule) : bit 57 (DST) 1, bit 58 (DST) 0
+	wwvb_tx.setDSTRule(wwvb_dst_us);
+	start(12, 0, 13, 3, 16);
+	wwvb_render _render(wwvb_tx, config_240kHz);
+	const std::vector<rendered_bit> _bits = demodulate(_render, 60);
+	const uint64_t _begins = wwvb_encode_frame(12, 0, 73, 16, WWVB_DST_BEGINS);
+	CHECK_EQUAL(wwvb_frame_symbol(_begins, 57), _bits[57].symbol);
+	CHECK_EQUAL(wwvb_frame_symbol(_begins, 58), _bits[58].symbol);
+	CHECK_EQUAL(1, _bits[57].symbol);
+	CHECK_EQUAL(0, _bits[58].symbol);
+
+	// no rule : 0 0
+	wwvb_tx.setDSTRule(wwvb_dst_none);
+	start(12, 0, 13, 3, 16);
+	wwvb_render _none(wwvb_tx, config_240kHz);
+	const std::vector<rendered_bit> _none_bits = demodulate(_none, 60);
+	CHECK_EQUAL(0, _none_bits[57].symbol);
+	CHECK_EQUAL(0, _none_bits[58].symbol);
+	wwvb_tx.setDSTRule(wwvb_dst_us);
+}
+
+void test_calibrate()
+{
+	// 60151 carrier periods of 1/60150s (1.00002s), then 60151 + 3000 (1.0499s) with calibrate(3000, 3000)
+	start(12, 0, 1, 7, 16);
+	wwvb_render _render(wwvb_tx, config_240kHz);
+	std::vector<rendered_bit> _bits = demodulate(_render, 4);
+	CHECK((_bits[1].ms >= 999) & (_bits[1].ms <= 1001));
+
+	start(12, 0, 1, 7, 16);
+	wwvb_tx.calibrate(3000, 3000);
+	wwvb_render _slow(wwvb_tx, config_240kHz);
+	_bits = demodulate(_slow, 4);
+	CHECK((_bits[1].ms >= 1049) & (_bits[1].ms <= 1051));
+}
+
+int main()
+{
+	test_duty();
+	test_leap_second();
+	test_dst();
+	test_calibrate();
+	return wwvb_test_result("render");
+}
@@ -0,0 +1,183 @@
+/*
+wwvb_state.h test (simulated EEPROM and RTC)
+
+* save -> restore gives the minute after the checkpoint, the calibration, the daylight savings mode
+  and WWVB_QUALITY_DEGRADED, with a timezone
+* rtc : synced() writes the rtc, restore keeps its minute and second, and after start(secs()) the real
+  interrupt routine changes the minute at the end of that frame. A stopped rtc falls back to the record
+* no record and no rtc : restore returns false
+* wear levelling : every slot is written in turn (no byte more than once a round), the seq wraps,
+  and a corrupted newest record falls back to the one before it
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+
+#define _DEBUG 0
+#define REQUIRE_TIMEDATESTRING 0
+
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+#include <wwvb_state.h>
+#include "wwvb_test.h"
+
+wwvb wwvb_tx;
+
+ISR(TIMER1_OVF_vect)
+{
+	wwvb_tx.interrupt_routine();
+}
+
+// erased EEPROM, stopped rtc
+void erase()
+{
+	wwvb_eeprom_sim &_sim = wwvb_eeprom_sim_state();
+	memset(_sim.data, 0xFF, sizeof(_sim.data));
+	memset(_sim.writes, 0, sizeof(_sim.writes));
+	wwvb_rtc_sim_state().running = false;
+}
+
+bool is_time(const uint8_t &_hour, const uint8_t &_mins, const uint8_t &_DD, const uint8_t &_MM, const uint8_t &_YY)
+{
+	return (wwvb_tx.hh() == _hour) & (wwvb_tx.mm() == _mins) & (wwvb_tx.DD() == _DD) & (wwvb_tx.MM() == _MM) & (wwvb_tx.YY() == _YY);
+}
+
+void test_round_trip()
+{
+	erase();
+
+	// 23:59 CST 31/12/2016 is 05:59 UTC 1/1/2017
+	wwvb_tx.setTimezone(6, 0);
+	wwvb_tx.set_time(23, 59, 31, 12, 16, WWVB_DST_YES);
+	wwvb_tx.calibrate(86, -40);
+	wwvb_state _saved;
+	_saved.save(wwvb_tx);
+	CHECK_EQUAL(WWVB_QUALITY_NONE, _saved.quality());
+
+	wwvb_tx.set_time(0, 0, 1, 1, 0);
+	wwvb_tx.calibrate(0, 0);
+	wwvb_state _restored;
+	CHECK(_restored.restore(wwvb_tx));
+	CHECK(is_time(6, 0, 1, 1, 17));
+	CHECK_EQUAL(0, _restored.secs());
+	CHECK_EQUAL(WWVB_DST_YES, wwvb_tx.getDSTMode());
+	CHECK_EQUAL(WWVB_QUALITY_DEGRADED, _restored.quality());
+	int16_t _c0 = 0, _c1 = 0;
+	wwvb_tx.getCalibration(_c0, _c1);
+	CHECK_EQUAL(86, _c0);
+	CHECK_EQUAL((uint16_t)-40, (uint16_t)_c1);
+
+	// nothing saved and no rtc
+	erase();
+	wwvb_state _empty;
+	CHECK(!_empty.restore(wwvb_tx));
+	CHECK_EQUAL(WWVB_QUALITY_NONE, _empty.quality());
+	_empty.setRTC(&wwvb_rtc_simulated);
+	CHECK(!_empty.restore(wwvb_tx));
+	wwvb_tx.setTimezone(0, 0);
+}
+
+void test_rtc()
+{
+	erase();
+
+	// synced at 12:34:45 UTC 13/3/2016, then the rtc keeps running through the reset
+	wwvb_tx.set_time(12, 34, 13, 3, 16);
+	wwvb_tx.start(45);
+	wwvb_tx.stop();
+	CHECK_EQUAL(45, wwvb_tx.ss());
+	wwvb_state _synced;
+	_synced.setRTC(&wwvb_rtc_simulated);
+	_synced.synced(wwvb_tx);
+	CHECK_EQUAL(WWVB_QUALITY_SYNCED, _synced.quality());
+	CHECK(wwvb_rtc_sim_state().running);
+	CHECK_EQUAL(45, wwvb_rtc_sim_state().secs);
+	wwvb_rtc_sim_state().secs = 50;
+
+	wwvb_tx.set_time(0, 0, 1, 1, 0);
+	wwvb_state _restored;
+	_restored.setRTC(&wwvb_rtc_simulated);
+	CHECK(_restored.restore(wwvb_tx));
+	CHECK(is_time(12, 34, 13, 3, 16));
+	CHECK_EQUAL(50, _restored.secs());
+
+	// the frame resumes at second 50, and the minute changes 10s later at the end of the frame
+	wwvb_tx.setup();
+	wwvb_tx.start(_restored.secs());
+	CHECK_EQUAL(50, wwvb_tx.ss());
+	const uint64_t _start = host_cycles;
+	while (wwvb_tx.frame_index != 0)
+	{
+		CHECK_EQUAL(34, wwvb_tx.mm());
+		host_tick();
+	}
+	wwvb_tx.stop();
+	CHECK(is_time(12, 35, 13, 3, 16));
+	CHECK_EQUAL(0, wwvb_tx.ss());
+	const double _seconds = (double)(host_cycles - _start) / F_CPU;
+	CHECK((_seconds > 9.9) & (_seconds < 10.1));
+
+	// a stopped rtc : the minute after the checkpoint that synced() made
+	wwvb_rtc_sim_state().running = false;
+	CHECK(_restored.restore(wwvb_tx));
+	CHECK(is_time(12, 35, 13, 3, 16));
+	CHECK_EQUAL(0, _restored.secs());
+}
+
+void test_wear_levelling()
+{
+	erase();
+
+	// 100 times round 32 slots (3200 saves, a seq wrap every 256)
+	wwvb_tx.set_time(0, 0, 1, 1, 17);
+	wwvb_state _state(64, 32);
+	for (uint16_t n = 0; n < 3200; ++n)
+	{
+		_state.save(wwvb_tx);
+		wwvb_tx.add_time(0, 1);
+	}
+	// only changed bytes are written : the seq of every slot 100 times, nothing more than that, and nothing outside
+	const wwvb_eeprom_sim &_sim = wwvb_eeprom_sim_state();
+	for (uint16_t a = 0; a < 1024; ++a)
+	{
+		const bool _is_record = (a >= 64) & (a < 64 + 32 * WWVB_STATE_RECORD_SIZE);
+		if (!_is_record) { CHECK_EQUAL(0, _sim.writes[a]); }
+		else if (((a - 64) % WWVB_STATE_RECORD_SIZE) == 0) { CHECK_EQUAL(100, _sim.writes[a]); }
+		else { CHECK(_sim.writes[a] <= 100); }
+	}
+
+	// the last save was 00:00 + 3199 minutes (05:19 3/1/2017)
+	wwvb_state _restored(64, 32);
+	CHECK(_restored.restore(wwvb_tx));
+	CHECK(is_time(5, 20, 3, 1, 17));
+
+	// a new wwvb_state carries on from the newest record (slot 0 of the next round)
+	wwvb_tx.set_time(12, 0, 3, 1, 17);
+	_restored.save(wwvb_tx);
+	CHECK_EQUAL(101, _sim.writes[64]);
+	CHECK_EQUAL(100, _sim.writes[64 + WWVB_STATE_RECORD_SIZE]);
+	wwvb_state _again(64, 32);
+	CHECK(_again.restore(wwvb_tx));
+	CHECK(is_time(12, 1, 3, 1, 17));
+
+	// corrupt the newest record : the one before it is used
+	wwvb_eeprom_sim_write(64 + 2, _sim.data[64 + 2] ^ 0x01);
+	wwvb_state _corrupted(64, 32);
+	CHECK(_corrupted.restore(wwvb_tx));
+	CHECK(is_time(5, 20, 3, 1, 17));
+}
+
+int main()
+{
+	sei();
+	test_round_trip();
+	test_rtc();
+	test_wear_levelling();
+	return wwvb_test_result("state");
+}
@@ -0,0 +1,204 @@
+/*
+wwvb_telemetry.h test
+
+Runs the real interrupt routine (host_tick, see extras/host/Arduino.h) with WWVB_TELEMETRY for 3 frames through
+the 2016 leap second, calling debug_time() and raw() each minute like examples/telemetry, and sends the buffer
+with service() into a simulated serial port
+
+* every record decodes, with the time and wwvb_encode_frame() bits of the minute it was made in
+* the decoded text is the text debug_time() and raw() print without WWVB_TELEMETRY (telemetry_text.cpp)
+* overrun : a record that doesnt fit is dropped whole (and counted), the ones before it are kept
+* wrap : records written and sent a few bytes at a time across the end of the ring buffer decode in order
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+
+#define _DEBUG 1
+#define REQUIRE_TIMEDATESTRING 0
+#define WWVB_TELEMETRY
+
+#include <string>
+#include <vector>
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+#include "wwvb_test.h"
+
+wwvb wwvb_tx;
+
+ISR(TIMER1_OVF_vect)
+{
+	wwvb_tx.interrupt_routine();
+}
+
+std::string wwvb_text_of(const uint8_t &_hour, const uint8_t &_mins, const uint8_t &_DD, const uint8_t &_MM, const uint8_t &_YY,
+	const int8_t &_dut1, const wwvb_leap_second *_leap, const uint8_t &_leap_count, const bool &_raw);
+
+const wwvb_leap_second leap_2016[1] = { { 16, 12 } };
+
+// a serial port with room for _room bytes each service()
+struct host_stream
+{
+	std::vector<uint8_t> bytes;
+	int room;
+
+	int availableForWrite() { return room; }
+	size_t write(uint8_t _byte) { bytes.push_back(_byte); return 1; }
+};
+
+// a record as sent : type, payload and the decoded text
+struct sent_record
+{
+	uint8_t type;
+	std::vector<uint8_t> payload;
+	std::string text;
+};
+
+// split the stream into records, and decode it with wwvb_telemetry_decoder
+std::vector<sent_record> decode(const std::vector<uint8_t> &_bytes)
+{
+	std::vector<sent_record> _records;
+	wwvb_telemetry_decoder _decoder;
+	size_t _start = 0;
+	for (size_t i = 0; i < _bytes.size(); ++i)
+	{
+		std::string _text;
+		if (!_decoder.decode(_bytes[i], _text))
+		{
+			continue;
+		}
+		CHECK_EQUAL(WWVB_TLM_SYNC, _bytes[_start]);
+		sent_record _record = { _bytes[_start + 1], std::vector<uint8_t>(_bytes.begin() + _start + 2, _bytes.begin() + i), _text };
+		_records.push_back(_record);
+		_start = i + 1;
+	}
+	CHECK_EQUAL(_bytes.size(), _start);
+	CHECK_EQUAL(0, _decoder.errors());
+	return _records;
+}
+
+// the time and frame of the record are the ones of _hour:_mins _DD/_MM/20_YY (DUT1 -0.4s, the 2016 leap second)
+void check_record(const sent_record &_record, const uint8_t &_hour, const uint8_t &_mins,
+	const uint8_t &_DD, const uint8_t &_MM, const uint8_t &_YY)
+{
+	const uint16_t _doty = to_day_of_the_year<uint8_t>(_DD, _MM, is_leap_year(2000 + _YY));
+	const uint64_t _frame = wwvb_encode_frame(_hour, _mins, _doty, _YY, WWVB_DST_NO, -4, (_YY == 16) & (_MM == 12));
+	const bool _raw = (_record.type == WWVB_TLM_RAW);
+	if (_raw)
+	{
+		CHECK_EQUAL(WWVB_TLM_RAW_SIZE, _record.payload.size());
+		CHECK_EQUAL(_frame, wwvb_telemetry_unpack_frame(_record.payload.data()));
+	}
+	else
+	{
+		CHECK_EQUAL(WWVB_TLM_STATE, _record.type);
+		CHECK_EQUAL(WWVB_TLM_STATE_SIZE, _record.payload.size());
+		CHECK((_record.payload[0] == _hour) & (_record.payload[1] == _mins) & (_record.payload[2] == _DD)
+			& (_record.payload[3] == _MM) & (_record.payload[4] == _YY));
+		CHECK_EQUAL(_frame, wwvb_telemetry_unpack_frame(_record.payload.data() + 5));
+	}
+	CHECK(_record.text == wwvb_text_of(_hour, _mins, _DD, _MM, _YY, -4, leap_2016, 1, _raw));
+}
+
+void test_frames()
+{
+	wwvb_tx.setup();
+	wwvb_tx.setDUT1(-4);
+	wwvb_tx.setLeapSecondSchedule(leap_2016, 1);
+	wwvb_tx.set_time(23, 58, 31, 12, 16);
+	host_stream _serial = { {}, 63 };
+	wwvb_tx.debug_time();
+	wwvb_tx.start();
+
+	// 23:58, 23:59 (61 seconds) and 00:00, a state and raw record at the start of each of the next minutes
+	uint8_t _mins = wwvb_tx.mm(), _minutes = 0;
+	while (_minutes < 3)
+	{
+		host_tick();
+		if (_mins != wwvb_tx.mm())
+		{
+			_mins = wwvb_tx.mm();
+			++_minutes;
+			wwvb_tx.debug_time();
+			wwvb_tx.raw();
+		}
+		wwvb_tx.telemetry.service(_serial);
+	}
+	wwvb_tx.stop();
+	CHECK_EQUAL(0, wwvb_tx.telemetry.available());
+	CHECK_EQUAL(0, wwvb_tx.telemetry.dropped());
+
+	const std::vector<sent_record> _records = decode(_serial.bytes);
+	CHECK_EQUAL(7, _records.size());
+	if (_records.size() != 7)
+	{
+		return;
+	}
+	check_record(_records[0], 23, 58, 31, 12, 16);
+	check_record(_records[1], 23, 59, 31, 12, 16);
+	check_record(_records[2], 23, 59, 31, 12, 16);
+	check_record(_records[3], 0, 0, 1, 1, 17);
+	check_record(_records[4], 0, 0, 1, 1, 17);
+	check_record(_records[5], 0, 1, 1, 1, 17);
+	check_record(_records[6], 0, 1, 1, 1, 17);
+	CHECK_EQUAL(WWVB_TLM_RAW, _records[2].type);
+}
+
+void test_wrap_overrun()
+{
+	wwvb_tx.set_time(12, 34, 13, 3, 17);
+	host_stream _serial = { {}, 0 };
+
+	// 63 bytes : 3 state records (48 bytes) fit, the 4th and 5th are dropped whole
+	for (uint8_t i = 0; i < 5; ++i)
+	{
+		wwvb_tx.debug_time();
+	}
+	CHECK_EQUAL(48, wwvb_tx.telemetry.available());
+	CHECK_EQUAL(2, wwvb_tx.telemetry.dropped());
+
+	// 5 bytes at a time, with a raw record (11 bytes) added after every 10 bytes sent : 48 + 33 bytes through
+	// the 64 byte ring
+	_serial.room = 5;
+	for (uint8_t i = 0; i < 3; ++i)
+	{
+		wwvb_tx.telemetry.service(_serial);
+		wwvb_tx.telemetry.service(_serial);
+		CHECK(wwvb_tx.telemetry.record(WWVB_TLM_RAW, std::vector<uint8_t>(WWVB_TLM_RAW_SIZE, 0x5A + i).data(), WWVB_TLM_RAW_SIZE));
+	}
+	while (wwvb_tx.telemetry.available())
+	{
+		wwvb_tx.telemetry.service(_serial);
+	}
+	CHECK_EQUAL(2, wwvb_tx.telemetry.dropped());
+	CHECK_EQUAL(48 + 33, _serial.bytes.size());
+
+	const std::vector<sent_record> _records = decode(_serial.bytes);
+	CHECK_EQUAL(6, _records.size());
+	if (_records.size() != 6)
+	{
+		return;
+	}
+	for (uint8_t i = 0; i < 3; ++i)
+	{
+		CHECK_EQUAL(WWVB_TLM_STATE, _records[i].type);
+		CHECK(_records[i].payload == _records[0].payload);
+		CHECK(_records[i].text == wwvb_text_of(12, 34, 13, 3, 17, -4, leap_2016, 1, false));
+		CHECK_EQUAL(WWVB_TLM_RAW, _records[3 + i].type);
+		CHECK(_records[3 + i].payload == std::vector<uint8_t>(WWVB_TLM_RAW_SIZE, 0x5A + i));
+	}
+}
+
+int main()
+{
+	sei();
+	test_frames();
+	test_wrap_overrun();
+	return wwvb_test_result("telemetry");
+}
@@ -0,0 +1,49 @@
+/*
+The text debug_time() and raw() print without WWVB_TELEMETRY, for the telemetry test (telemetry.cpp)
+
+wwvb is renamed wwvb_text here, so this build of it can be linked with the WWVB_TELEMETRY one
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+
+#define _DEBUG 1
+#define REQUIRE_TIMEDATESTRING 0
+
+#include <string>
+#include <TimeDateTools.h> // include before wwvb.h
+#define wwvb wwvb_text
+#include <wwvb.h>
+#undef wwvb
+
+// a global, like wwvb_tx in a sketch (the time registers start at 0)
+wwvb_text text_tx;
+
+// the text of debug_time() (or raw()) at _hour:_mins _DD/_MM/20_YY with DUT1 _dut1 and the leap second schedule
+std::string wwvb_text_of(const uint8_t &_hour, const uint8_t &_mins, const uint8_t &_DD, const uint8_t &_MM, const uint8_t &_YY,
+	const int8_t &_dut1, const wwvb_leap_second *_leap, const uint8_t &_leap_count, const bool &_raw)
+{
+	text_tx.setDUT1(_dut1);
+	text_tx.setLeapSecondSchedule(_leap, _leap_count);
+	text_tx.set_time(_hour, _mins, _DD, _MM, _YY);
+
+	FILE *_file = tmpfile();
+	host_serial = _file;
+	if (_raw) { text_tx.raw(); }
+	else { text_tx.debug_time(); }
+	host_serial = stdout;
+
+	std::string _text;
+	rewind(_file);
+	for (int c = fgetc(_file); c != EOF; c = fgetc(_file))
+	{
+		_text += (char)c;
+	}
+	fclose(_file);
+	return _text;
+}
@@ -0,0 +1,252 @@
+/*
+Century time warp simulator
+
+usage : test_time_warp_century [first YY] [years]
+Runs the real wwvb::interrupt_routine() from the simulated Timer1 (host_tick, see extras/host/Arduino.h)
+with WWVB_TIMEWARP 6015 (10 isr ticks per bit) across 2000 - 2099 and the 2099 -> 2000 wrap,
+and checks every frame it sends against a reference calendar that shares no code with wwvb.h / wwvb_frame.h
+(days from 1 Jan 2000, the US daylight savings rule, the DUT1 and leap second schedules)
+
+* every hour, day, month and year rollover : the clock is set to hh:59 and the isr runs into the next hour,
+  so the hh:59 frame and the frame after the rollover are both checked (36525 days x 24 hours)
+* every minute rollover of 31 Dec 2016 (the leap second day) : one continuous day of frames
+* the real leap seconds of the century so far (61 bit 23:59 frames) and DUT1 steps
+
+The isr runs add_time() for every bit, which bounds a continuous century at a few minutes on the host,
+so the rollovers are run from the last minute before each of them instead.
+Prints one line per year (20YY,frames,mismatches) and any mismatching frame, returns 1 on a mismatch
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+
+#define _DEBUG 0
+#define REQUIRE_TIMEDATESTRING 0
+#define WWVB_TIMEWARP 6015 // 1s -> 10 isr ticks
+
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+#include "wwvb_test.h"
+
+wwvb wwvb_tx;
+
+ISR(TIMER1_OVF_vect)
+{
+	wwvb_tx.interrupt_routine();
+}
+
+const wwvb_leap_second leap_seconds[5] = { { 5, 12 }, { 8, 12 }, { 12, 6 }, { 15, 6 }, { 16, 12 } };
+const wwvb_dut1_step dut1_steps[4] = { { 5, 1, 3 }, { 6, 1, -6 }, { 16, 335, -4 }, { 17, 1, 6 } };
+
+// reference calendar : day _n (0 = 1 Jan 2000) as YY, MM, DD, day of the year and day of the week (0 - Sunday)
+struct reference_day
+{
+	uint8_t YY, MM, DD, dow;
+	uint16_t doty;
+};
+
+bool reference_is_leap(const uint16_t &_YYYY)
+{
+	return ((_YYYY % 4 == 0) & (_YYYY % 100 != 0)) | (_YYYY % 400 == 0);
+}
+
+reference_day reference(uint32_t _n)
+{
+	static const uint8_t month_days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	reference_day _day;
+	_day.dow = (_n + 6) % 7; // 1 Jan 2000 was a Saturday
+	uint16_t _YYYY = 2000;
+	while (_n >= 365U + reference_is_leap(_YYYY))
+	{
+		_n -= 365 + reference_is_leap(_YYYY);
+		++_YYYY;
+	}
+	_day.YY = _YYYY % 100;
+	_day.doty = _n + 1;
+	_day.MM = 1;
+	while (_n >= month_days[_day.MM - 1] + (uint32_t)((_day.MM == 2) & reference_is_leap(_YYYY)))
+	{
+		_n -= month_days[_day.MM - 1] + ((_day.MM == 2) & reference_is_leap(_YYYY));
+		++_day.MM;
+	}
+	_day.DD = _n + 1;
+	return _day;
+}
+
+// US daylight savings of each year : the days of the 2nd Sunday in March and the 1st Sunday in November
+uint16_t dst_begin[100], dst_end[100];
+
+void reference_dst(const uint32_t &_century)
+{
+	for (uint32_t n = 0; n < _century; ++n)
+	{
+		const reference_day _d = reference(n);
+		if ((_d.dow == 0) & (_d.MM == 3) & (_d.DD > 7) & (_d.DD <= 14)) { dst_begin[_d.YY] = _d.doty; }
+		if ((_d.dow == 0) & (_d.MM == 11) & (_d.DD <= 7)) { dst_end[_d.YY] = _d.doty; }
+	}
+}
+
+// reference frame for hh:mm of day _n (NIST : bit n is the data bit sent at second n)
+struct reference_frame
+{
+	uint64_t frame;
+	uint8_t length;
+};
+
+reference_frame reference_frame_of(const uint32_t &_n, const uint8_t &_hh, const uint8_t &_mm)
+{
+	const reference_day _day = reference(_n);
+
+	// daylight savings as at 00:00 and 24:00 UTC
+	const uint16_t _begin = dst_begin[_day.YY], _end = dst_end[_day.YY];
+	const bool _dst_start = (_day.doty > _begin) & (_day.doty <= _end);
+	const bool _dst_end = (_day.doty >= _begin) & (_day.doty < _end);
+
+	// DUT1 : the last step on or before today
+	int8_t _dut1 = 0;
+	for (uint8_t i = 0; i < 4; ++i)
+	{
+		if ((dut1_steps[i].YY < _day.YY) | ((dut1_steps[i].YY == _day.YY) & (dut1_steps[i].doty <= _day.doty)))
+		{
+			_dut1 = dut1_steps[i].dut1;
+		}
+	}
+
+	// leap second : the warning all month, 61 bits at 23:59 on the last day of the month
+	bool _warning = false, _leap_minute = false;
+	for (uint8_t i = 0; i < 5; ++i)
+	{
+		if ((leap_seconds[i].YY == _day.YY) & (leap_seconds[i].MM == _day.MM))
+		{
+			_warning = true;
+			_leap_minute = (reference(_n + 1).MM != _day.MM) & (_hh == 23) & (_mm == 59);
+		}
+	}
+
+	// second : value
+	uint8_t _sent[61] = { 0 };
+	const uint8_t _markers[7] = { 0, 9, 19, 29, 39, 49, 59 };
+	const uint8_t _mins_weights[8] = { 40, 20, 10, 0, 8, 4, 2, 1 };     // seconds 1 - 8
+	const uint8_t _hour_weights[7] = { 20, 10, 0, 8, 4, 2, 1 };         // seconds 12 - 18
+	const uint16_t _doty_weights[12] = { 200, 100, 0, 80, 40, 20, 10, 0, 8, 4, 2, 1 }; // seconds 22 - 33
+	const uint8_t _year_weights[8] = { 80, 40, 20, 10, 0, 8, 4, 2 };     // seconds 45 - 52, 53 is 1 (below)
+	const uint8_t _dut1_weights[4] = { 8, 4, 2, 1 };                     // seconds 40 - 43
+	uint8_t _v = _mm;
+	for (uint8_t i = 0; i < 8; ++i) { if (_mins_weights[i] && _v >= _mins_weights[i]) { _v -= _mins_weights[i]; _sent[1 + i] = 1; } }
+	_v = _hh;
+	for (uint8_t i = 0; i < 7; ++i) { if (_hour_weights[i] && _v >= _hour_weights[i]) { _v -= _hour_weights[i]; _sent[12 + i] = 1; } }
+	uint16_t _d = _day.doty;
+	for (uint8_t i = 0; i < 12; ++i) { if (_doty_weights[i] && _d >= _doty_weights[i]) { _d -= _doty_weights[i]; _sent[22 + i] = 1; } }
+	_v = _day.YY;
+	for (uint8_t i = 0; i < 8; ++i) { if (_year_weights[i] && _v >= _year_weights[i]) { _v -= _year_weights[i]; _sent[45 + i] = 1; } }
+	_sent[53] = _v & 0x01;
+	_sent[36] = _sent[38] = (_dut1 >= 0);
+	_sent[37] = (_dut1 < 0);
+	_v = (_dut1 < 0) ? -_dut1 : _dut1;
+	for (uint8_t i = 0; i < 4; ++i) { if (_v >= _dut1_weights[i]) { _v -= _dut1_weights[i]; _sent[40 + i] = 1; } }
+	_sent[55] = reference_is_leap(2000 + _day.YY);
+	_sent[56] = _warning;
+	_sent[57] = _dst_end;
+	_sent[58] = _dst_start;
+	for (uint8_t i = 0; i < 7; ++i) { _sent[_markers[i]] = 0; }
+
+	reference_frame _ref;
+	_ref.frame = 0;
+	for (uint8_t i = 0; i < 60; ++i)
+	{
+		_ref.frame |= (uint64_t)_sent[i] << i;
+	}
+	_ref.length = 60 + _leap_minute;
+	return _ref;
+}
+
+uint32_t frames = 0;
+
+bool check_frame(const uint32_t &_n, const uint8_t &_hh, const uint8_t &_mm)
+{
+	const reference_frame _ref = reference_frame_of(_n, _hh, _mm);
+	++frames;
+	const bool _pass = CHECK_EQUAL(_ref.frame, wwvb_tx.frame()) & CHECK_EQUAL(_ref.length, wwvb_tx.frame_length());
+	if (!_pass)
+	{
+		const reference_day _day = reference(_n);
+		printf("    at %02u:%02u %02u/%02u/20%02u (day %u)\n", _hh, _mm, _day.DD, _day.MM, _day.YY, _day.doty);
+	}
+	return _pass;
+}
+
+// run the simulated Timer1 until the next frame starts
+void next_frame()
+{
+	while (wwvb_tx.frame_index == 0) { host_tick(); }
+	while (wwvb_tx.frame_index != 0) { host_tick(); }
+}
+
+// set the clock to _hh:_mm of day _n and start sending
+void start_at(const uint32_t &_n, const uint8_t &_hh, const uint8_t &_mm)
+{
+	const reference_day _day = reference(_n);
+	wwvb_tx.stop();
+	wwvb_tx.set_time(_hh, _mm, _day.DD, _day.MM, _day.YY, WWVB_DST_AUTO);
+	wwvb_tx.start();
+}
+
+int main(int argc, char *argv[])
+{
+	const uint32_t _first_YY = (argc > 1) ? strtoul(argv[1], 0, 10) : 0;
+	const uint32_t _years = (argc > 2) ? strtoul(argv[2], 0, 10) : 100;
+
+	// day numbers of 1 Jan of each year, and the end of the century (the 2099 -> 2000 wrap)
+	uint32_t _year_start[101];
+	_year_start[0] = 0;
+	for (uint8_t YY = 0; YY < 100; ++YY)
+	{
+		_year_start[YY + 1] = _year_start[YY] + 365 + reference_is_leap(2000 + YY);
+	}
+	const uint32_t _century = _year_start[100];
+	reference_dst(_century);
+
+	sei();
+	wwvb_tx.setup();
+	wwvb_tx.setLeapSecondSchedule(leap_seconds, 5);
+	wwvb_tx.setDUT1Schedule(dut1_steps, 4);
+
+	// one continuous day, every minute rollover (and the leap second at the end of it)
+	const uint32_t _leap_day = _year_start[16] + 365;
+	if ((_first_YY <= 16) & (_first_YY + _years > 16))
+	{
+		start_at(_leap_day, 0, 0);
+		check_frame(_leap_day, 0, 0);
+		for (uint16_t m = 1; m <= 1440; ++m)
+		{
+			next_frame();
+			check_frame(_leap_day + m / 1440, (m / 60) % 24, m % 60);
+		}
+	}
+
+	// the last minute of every hour, and the frame after it
+	for (uint32_t YY = _first_YY; (YY < _first_YY + _years) & (YY < 100); ++YY)
+	{
+		const uint32_t _failures = wwvb_test_failures();
+		const uint32_t _frames = frames;
+		for (uint32_t n = _year_start[YY]; n < _year_start[YY + 1]; ++n)
+		{
+			for (uint8_t hh = 0; hh < 24; ++hh)
+			{
+				start_at(n, hh, 59);
+				check_frame(n, hh, 59);
+				next_frame();
+				const uint32_t _next = (hh == 23) ? (n + 1) % _century : n;
+				check_frame(_next, (hh + 1) % 24, 0);
+			}
+		}
+		printf("20%02u,%u,%u\n", YY, frames - _frames, wwvb_test_failures() - _failures);
+	}
+	return wwvb_test_result("time_warp_century");
+}
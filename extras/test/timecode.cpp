@@ -0,0 +1,213 @@
+/*
+timecode.h / timecode_formats.h test
+
+Runs the real timecode::interrupt_routine() from the simulated Timer1 (host_tick, see extras/host/Arduino.h)
+and decodes the hour, minute and summer time bits of each frame it sends
+
+* DCF77 (EU rule, 01:00 UTC) : 01:59 CET -> 03:00 CEST on 27/03/2016, and 02:59 CEST -> 02:00 CET on 30/10/2016
+  then CET on through 03:00
+* MSF : 00:59 GMT -> 02:00 BST on 27/03/2016, and 01:59 BST -> 01:00 GMT on 30/10/2016
+* the frames sent are the frames timecode_encode_frame() makes
+* the isr never enables interrupts (the next frame is encoded a symbol at a time, not in a nested isr)
+* set_time() with a fixed daylight savings code keeps the rule from setDSTRule() for the next WWVB_DST_AUTO
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+
+#define _DEBUG 0
+#define REQUIRE_TIMEDATESTRING 0
+
+#include <TimeDateTools.h> // include before timecode.h
+#include <timecode.h>
+#include "wwvb_test.h"
+
+timecode<timecode_dcf77> dcf77_tx;
+timecode<timecode_msf> msf_tx;
+
+// the transmitter being run
+void (*tx_isr)() = 0;
+uint32_t nested = 0;
+
+ISR(TIMER1_OVF_vect)
+{
+	tx_isr();
+	nested += (SREG & _BV(SREG_I)) != 0;
+}
+
+// hour, minute and summer time as sent
+struct sent_time
+{
+	uint8_t hh, mm, summer;
+};
+
+uint8_t bits(const uint8_t *_symbols, const uint8_t *_seconds, const uint8_t *_weights, const uint8_t &_n, const uint8_t &_mask)
+{
+	uint8_t _value = 0;
+	for (uint8_t i = 0; i < _n; ++i)
+	{
+		_value += (_symbols[_seconds[i]] & _mask) ? _weights[i] : 0;
+	}
+	return _value;
+}
+
+// DCF77 : 21-27 minute (1 2 4 8 10 20 40), 29-34 hour (1 2 4 8 10 20), 17 CEST, 18 CET
+sent_time decode_dcf77(const uint8_t *_symbols)
+{
+	static const uint8_t _mins_s[7] = { 21, 22, 23, 24, 25, 26, 27 }, _mins_w[7] = { 1, 2, 4, 8, 10, 20, 40 };
+	static const uint8_t _hour_s[6] = { 29, 30, 31, 32, 33, 34 }, _hour_w[6] = { 1, 2, 4, 8, 10, 20 };
+	sent_time _t;
+	_t.mm = bits(_symbols, _mins_s, _mins_w, 7, 0x01);
+	_t.hh = bits(_symbols, _hour_s, _hour_w, 6, 0x01);
+	_t.summer = _symbols[17];
+	CHECK_EQUAL(_t.summer, !_symbols[18]);
+	return _t;
+}
+
+// MSF : A 39-44 hour (20 10 8 4 2 1), A 45-51 minute (40 ... 1), B 58 British Summer Time
+sent_time decode_msf(const uint8_t *_symbols)
+{
+	static const uint8_t _hour_s[6] = { 39, 40, 41, 42, 43, 44 }, _hour_w[6] = { 20, 10, 8, 4, 2, 1 };
+	static const uint8_t _mins_s[7] = { 45, 46, 47, 48, 49, 50, 51 }, _mins_w[7] = { 40, 20, 10, 8, 4, 2, 1 };
+	static const uint8_t _bst_s[1] = { 58 }, _bst_w[1] = { 1 };
+	sent_time _t;
+	_t.mm = bits(_symbols, _mins_s, _mins_w, 7, 0x01);
+	_t.hh = bits(_symbols, _hour_s, _hour_w, 6, 0x01);
+	_t.summer = bits(_symbols, _bst_s, _bst_w, 1, 0x02);
+	return _t;
+}
+
+// the frame being sent
+template <typename FORMAT>
+void sent_frame(timecode<FORMAT> &_tx, uint8_t *_symbols)
+{
+	for (uint8_t i = 0; i < FORMAT::seconds; ++i)
+	{
+		_symbols[i] = _tx.symbol(i);
+	}
+}
+
+// run the simulated Timer1 until the next frame starts
+template <typename FORMAT>
+void next_frame(timecode<FORMAT> &_tx)
+{
+	while (_tx.frame_index == 0) { host_tick(); }
+	while (_tx.frame_index != 0) { host_tick(); }
+}
+
+// send _count frames from _hour:_mins _DD/_MM/_YY, and check the times sent (and that each frame is
+// the one timecode_encode_frame makes)
+template <typename FORMAT>
+void check_frames(timecode<FORMAT> &_tx, sent_time (*_decode)(const uint8_t *),
+	const uint8_t &_hour, const uint8_t &_mins, const uint8_t &_DD, const uint8_t &_MM, const uint8_t &_YY,
+	const sent_time *_expected, const uint8_t &_count)
+{
+	_tx.stop();
+	_tx.setup();
+	_tx.set_time(_hour, _mins, _DD, _MM, _YY);
+	_tx.start();
+
+	timecode_time _t;
+	timecode_set_time(_t, _hour, _mins, _DD, _MM, _YY, WWVB_DST_AUTO, FORMAT::dst_rule, FORMAT::dst_hour);
+	for (uint8_t i = 0; i < FORMAT::minute_offset; ++i)
+	{
+		timecode_next_minute(_t, FORMAT::dst_rule, FORMAT::dst_hour);
+	}
+
+	uint8_t _symbols[FORMAT::seconds], _reference[FORMAT::seconds];
+	for (uint8_t n = 0; n < _count; ++n)
+	{
+		if (n > 0)
+		{
+			next_frame(_tx);
+			timecode_next_minute(_t, FORMAT::dst_rule, FORMAT::dst_hour);
+		}
+		sent_frame(_tx, _symbols);
+		const sent_time _sent = _decode(_symbols);
+		const bool _pass = CHECK_EQUAL(_expected[n].hh, _sent.hh) & CHECK_EQUAL(_expected[n].mm, _sent.mm)
+			& CHECK_EQUAL(_expected[n].summer, _sent.summer) & CHECK_EQUAL(_expected[n].mm, _tx.mm());
+		if (!_pass)
+		{
+			printf("    frame %u after %02u:%02u %02u/%02u/20%02u\n", n, _hour, _mins, _DD, _MM, _YY);
+		}
+
+		timecode_encode_frame<FORMAT>(_t, _reference);
+		CHECK(memcmp(_symbols, _reference, FORMAT::seconds) == 0);
+	}
+}
+
+void run_dcf77() { dcf77_tx.interrupt_routine(); }
+void run_msf() { msf_tx.interrupt_routine(); }
+
+void test_dcf77()
+{
+	tx_isr = run_dcf77;
+
+	// DCF77 sends the time of the next minute marker
+	const sent_time _spring[4] = { { 1, 58, 0 }, { 1, 59, 0 }, { 3, 0, 1 }, { 3, 1, 1 } };
+	check_frames(dcf77_tx, decode_dcf77, 1, 57, 27, 3, 16, _spring, 4);
+
+	// 02:00 - 02:59 is sent twice, CEST then CET, and CET carries on through 03:00
+	sent_time _autumn[64] = { { 2, 58, 1 }, { 2, 59, 1 } };
+	for (uint8_t m = 0; m < 60; ++m)
+	{
+		_autumn[2 + m] = { 2, m, 0 };
+	}
+	_autumn[62] = { 3, 0, 0 };
+	_autumn[63] = { 3, 1, 0 };
+	check_frames(dcf77_tx, decode_dcf77, 2, 57, 30, 10, 16, _autumn, 64);
+
+	const sent_time _summer[2] = { { 12, 1, 1 }, { 12, 2, 1 } };
+	check_frames(dcf77_tx, decode_dcf77, 12, 0, 1, 7, 16, _summer, 2);
+	const sent_time _winter[2] = { { 0, 0, 0 }, { 0, 1, 0 } };
+	check_frames(dcf77_tx, decode_dcf77, 23, 59, 31, 12, 16, _winter, 2);
+}
+
+void test_msf()
+{
+	tx_isr = run_msf;
+
+	const sent_time _spring[4] = { { 0, 58, 0 }, { 0, 59, 0 }, { 2, 0, 1 }, { 2, 1, 1 } };
+	check_frames(msf_tx, decode_msf, 0, 57, 27, 3, 16, _spring, 4);
+
+	const sent_time _autumn[4] = { { 1, 58, 1 }, { 1, 59, 1 }, { 1, 0, 0 }, { 1, 1, 0 } };
+	check_frames(msf_tx, decode_msf, 1, 57, 30, 10, 16, _autumn, 4);
+}
+
+void test_dst_rule()
+{
+	uint8_t _symbols[60];
+
+	// a fixed code is sent as is
+	dcf77_tx.setDSTRule(wwvb_dst_none);
+	dcf77_tx.set_time(12, 0, 1, 7, 16, WWVB_DST_YES);
+	sent_frame(dcf77_tx, _symbols);
+	CHECK_EQUAL(1, decode_dcf77(_symbols).summer);
+
+	// and the rule is still there for WWVB_DST_AUTO
+	dcf77_tx.set_time(12, 0, 1, 7, 16);
+	sent_frame(dcf77_tx, _symbols);
+	CHECK_EQUAL(0, decode_dcf77(_symbols).summer);
+
+	// 0 is the rule of the format
+	dcf77_tx.setDSTRule(0);
+	dcf77_tx.set_time(12, 0, 1, 7, 16);
+	sent_frame(dcf77_tx, _symbols);
+	CHECK_EQUAL(1, decode_dcf77(_symbols).summer);
+}
+
+int main()
+{
+	sei();
+	test_dcf77();
+	test_msf();
+	test_dst_rule();
+	CHECK_EQUAL(0, nested);
+	return wwvb_test_result("timecode");
+}
@@ -0,0 +1,59 @@
+#ifndef wwvb_test_h
+#define wwvb_test_h
+
+/*
+Minimal host test harness : CHECK(condition) and CHECK_EQUAL(expected, actual) count and print failures,
+and main() returns wwvb_test_result() (0 if everything passed), which is what ctest looks at
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+
+inline uint32_t &wwvb_test_checks()
+{
+	static uint32_t _checks = 0;
+	return _checks;
+}
+inline uint32_t &wwvb_test_failures()
+{
+	static uint32_t _failures = 0;
+	return _failures;
+}
+
+// only the first few failures are printed
+inline bool wwvb_test_check(const bool &_pass, const char *_what, const char *_file, const int &_line)
+{
+	++wwvb_test_checks();
+	if (!_pass && (++wwvb_test_failures() <= 20))
+	{
+		printf("%s:%d: FAILED %s\n", _file, _line, _what);
+	}
+	return _pass;
+}
+
+inline bool wwvb_test_check_equal(const uint64_t &_expected, const uint64_t &_actual, const char *_what, const char *_file, const int &_line)
+{
+	const bool _pass = wwvb_test_check(_expected == _actual, _what, _file, _line);
+	if (!_pass && (wwvb_test_failures() <= 20))
+	{
+		printf("    expected 0x%016llx, got 0x%016llx\n", (unsigned long long)_expected, (unsigned long long)_actual);
+	}
+	return _pass;
+}
+
+#define CHECK(condition) wwvb_test_check((condition), #condition, __FILE__, __LINE__)
+#define CHECK_EQUAL(expected, actual) wwvb_test_check_equal((expected), (actual), #expected " == " #actual, __FILE__, __LINE__)
+
+inline int wwvb_test_result(const char *_name)
+{
+	printf("%s : %u checks, %u failed\n", _name, wwvb_test_checks(), wwvb_test_failures());
+	return wwvb_test_failures() ? 1 : 0;
+}
+
+#endif
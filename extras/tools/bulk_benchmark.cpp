@@ -0,0 +1,94 @@
+/*
+Scalar vs SIMD benchmark of the bulk frame encoder (wwvb_frame.h)
+
+usage : bulk_benchmark [frames]
+Encodes the same pseudo-random fields (hour, minute, day, year, daylight savings, DUT1, leap second warning)
+with wwvb_encode_bulk_scalar and wwvb_encode_bulk (SSE2, or AVX2 when built with -mavx2), checks that the frames match,
+and prints one csv line per encoder (the best of 5 runs):
+
+encoder,frames,ns_per_frame,frames_per_s
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include <wwvb_frame.h>
+
+typedef void (*bulk_encoder)(const uint8_t *, const uint8_t *, const uint16_t *, const uint8_t *, const uint8_t *,
+	const int8_t *, const uint8_t *, uint64_t *, const uint32_t &);
+
+struct bulk_input
+{
+	std::vector<uint8_t> hour, mins, YY, daylight_savings, leap_second_warning;
+	std::vector<uint16_t> doty;
+	std::vector<int8_t> dut1;
+};
+
+// best of 5 runs, in ns per frame
+double run(bulk_encoder _encoder, const bulk_input &_in, std::vector<uint64_t> &_frames)
+{
+	double _best = 1e30;
+	for (uint8_t r = 0; r < 5; ++r)
+	{
+		const std::chrono::steady_clock::time_point _t0 = std::chrono::steady_clock::now();
+		_encoder(_in.hour.data(), _in.mins.data(), _in.doty.data(), _in.YY.data(), _in.daylight_savings.data(),
+			_in.dut1.data(), _in.leap_second_warning.data(), _frames.data(), _frames.size());
+		const double _ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - _t0).count();
+		if (_ns < _best) { _best = _ns; }
+	}
+	return _best / _frames.size();
+}
+
+void report(const char *_encoder, const uint32_t &_count, const double &_ns_per_frame)
+{
+	printf("%s,%u,%.3f,%.0f\n", _encoder, _count, _ns_per_frame, 1e9 / _ns_per_frame);
+}
+
+int main(int argc, char *argv[])
+{
+	const uint32_t _count = (argc > 1) ? strtoul(argv[1], 0, 10) : 1000000;
+
+	bulk_input _in;
+	srand(1);
+	for (uint32_t i = 0; i < _count; ++i)
+	{
+		const uint8_t _YY = rand() % 100;
+		_in.hour.push_back(rand() % 24);
+		_in.mins.push_back(rand() % 60);
+		_in.doty.push_back(1 + rand() % (365 + wwvb_frame_is_leap_year(_YY)));
+		_in.YY.push_back(_YY);
+		_in.daylight_savings.push_back(rand() % 4);
+		_in.dut1.push_back(rand() % 19 - 9);
+		_in.leap_second_warning.push_back(rand() % 2);
+	}
+
+	std::vector<uint64_t> _scalar(_count), _simd(_count);
+	const double _scalar_ns = run(wwvb_encode_bulk_scalar, _in, _scalar);
+	const double _simd_ns = run(wwvb_encode_bulk, _in, _simd);
+
+	printf("encoder,frames,ns_per_frame,frames_per_s\n");
+	report("scalar", _count, _scalar_ns);
+#if defined(__AVX2__)
+	report("avx2", _count, _simd_ns);
+#elif defined(__SSE2__)
+	report("sse2", _count, _simd_ns);
+#else
+	report("scalar", _count, _simd_ns);
+#endif
+
+	if (memcmp(_scalar.data(), _simd.data(), _count * sizeof(uint64_t)) != 0)
+	{
+		printf("error : the SIMD frames dont match the scalar frames\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,64 @@
+/*
+Monte Carlo drift and jitter sweep : the tick model (wwvb_montecarlo.h) and the real interrupt routine
+(extras/host/wwvb_montecarlo_isr.h) over the same grid
+
+usage : montecarlo [trials] [frames] [crystal ppm] [lost tick ppm] [latency cycles]
+The grid is calibrate() -300 - 300 in steps of 100, ICR1 133 and 134, PWM_LOW 6 and 40 (16MHz).
+Prints one csv line per driver and grid point :
+
+driver,calibrate,icr1,pwm_low,trials,frames,acceptance,mean_lock_s,mean_us,rms_us,max_us
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+
+#define _DEBUG 0
+#define REQUIRE_TIMEDATESTRING 0
+
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+#include <wwvb_montecarlo_isr.h>
+
+void report(const char *_driver, const wwvb_mc_point &_point, wwvb_mc_result &_result)
+{
+	printf("%s,%d,%u,%u,%u,%u,%.3f,%.1f,%.1f,%.1f,%.1f\n", _driver, _point.calibrate, _point.icr1, _point.pwm_low,
+		_result.trials, _result.frames, _result.acceptance(), _result.mean_lock_s(),
+		_result.mean_us(), _result.rms_us(), _result.frame_error_max_us);
+}
+
+int main(int argc, char *argv[])
+{
+	wwvb_mc_config _cfg = { 16000000, { 12030, 30075, 48120 }, 60150, 66, 20.0f, 1.0f, 200, 3, WWVB_RX_TYPICAL };
+	const uint32_t _trials = (argc > 1) ? strtoul(argv[1], 0, 10) : 8;
+	if (argc > 2) { _cfg.frames = strtoul(argv[2], 0, 10); }
+	if (argc > 3) { _cfg.crystal_ppm = strtof(argv[3], 0); }
+	if (argc > 4) { _cfg.lost_tick_ppm = strtof(argv[4], 0); }
+	if (argc > 5) { _cfg.latency_cycles = strtoul(argv[5], 0, 10); }
+
+	std::vector<wwvb_mc_point> _grid;
+	for (int16_t _calibrate = -300; _calibrate <= 300; _calibrate += 100)
+	{
+		for (uint16_t _icr1 = 133; _icr1 <= 134; ++_icr1)
+		{
+			_grid.push_back({ _calibrate, _icr1, 6 });
+			_grid.push_back({ _calibrate, _icr1, 40 });
+		}
+	}
+
+	std::vector<wwvb_mc_result> _model(_grid.size()), _isr(_grid.size());
+	wwvb_montecarlo(_cfg, _grid.data(), _grid.size(), _trials, _model.data());
+	wwvb_montecarlo_isr(_cfg, _grid.data(), _grid.size(), _trials, _isr.data());
+
+	printf("driver,calibrate,icr1,pwm_low,trials,frames,acceptance,mean_lock_s,mean_us,rms_us,max_us\n");
+	for (size_t p = 0; p < _grid.size(); ++p)
+	{
+		report("model", _grid[p], _model[p]);
+		report("isr", _grid[p], _isr[p]);
+	}
+	return 0;
+}
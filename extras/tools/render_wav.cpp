@@ -0,0 +1,156 @@
+/*
+Render the transmitted signal to a wav file (wwvb_render.h)
+
+usage : render_wav <out.wav> [options]
+  -s seconds     length (default 120)
+  -t hh:mm       start time, UTC as sent (default 23:58)
+  -d YY:doty     start day (default 16:366)
+  -r rate        sample rate (default 240000, or 8000 with -iq)
+  -iq            complex baseband (2 channel wav, I and Q) mixed down from 60000Hz, rather than the PWM output
+  -dst code      a fixed daylight savings code 0 - 3 (default : the US rule)
+  -dut1 tenths   DUT1 -9 - 9 (default 0)
+  -leap YY:MM    a leap second at the end of month MM of 20YY
+  -cal ticks     calibrate(ticks, ticks) (default 0)
+
+The signal is what a wwvb sends (wwvb::interrupt_routine() run by wwvb_render) on a 16MHz ATmega328p :
+ICR1 133, PWM_HIGH 66, PWM_LOW 6, see wwvb::setup(). It is built three times, for the library options :
+render_wav (PWM), render_wav_pam (WWVB_PAM, the carrier is off for low) and render_wav_pm (WWVB_PM, phase modulation)
+e.g. render_wav leap.wav -s 180 -d 16:366 -t 23:58 -leap 16:12 -dut1 -4 has the 61 bit 23:59 frame of 31/12/2016
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+
+#define _DEBUG 0
+#define REQUIRE_TIMEDATESTRING 0
+
+#include <vector>
+#include <TimeDateTools.h> // include before wwvb.h
+#include <wwvb.h>
+#include <wwvb_render.h>
+
+wwvb wwvb_tx;
+
+int usage()
+{
+	fprintf(stderr, "usage : render_wav <out.wav> [-s seconds] [-t hh:mm] [-d YY:doty] [-r rate] [-iq]"
+		" [-dst code] [-dut1 tenths] [-leap YY:MM] [-cal ticks]\n");
+	return 1;
+}
+
+// "a:b" -> _a, _b
+bool pair(const char *_arg, long &_a, long &_b)
+{
+	char *_end;
+	_a = strtol(_arg, &_end, 10);
+	if (*_end != ':')
+	{
+		return false;
+	}
+	_b = strtol(_end + 1, &_end, 10);
+	return *_end == 0;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		return usage();
+	}
+	const char *_path = argv[1];
+
+	wwvb_render_config _cfg = { 0, 0.0f, 60000 };
+	uint32_t _seconds = 120;
+	long _hour = 23, _mins = 58, _YY = 16, _doty = 366;
+	long _dst = WWVB_DST_AUTO, _dut1 = 0, _leap_YY = 0, _leap_MM = 0, _cal = 0;
+	bool _iq = false;
+
+	for (int i = 2; i < argc; ++i)
+	{
+		const bool _has_value = (i + 1 < argc);
+		if (!strcmp(argv[i], "-iq")) { _iq = true; }
+		else if (!strcmp(argv[i], "-s") & _has_value) { _seconds = strtoul(argv[++i], 0, 10); }
+		else if (!strcmp(argv[i], "-r") & _has_value) { _cfg.sample_rate = strtoul(argv[++i], 0, 10); }
+		else if (!strcmp(argv[i], "-dst") & _has_value) { _dst = strtol(argv[++i], 0, 10); }
+		else if (!strcmp(argv[i], "-dut1") & _has_value) { _dut1 = strtol(argv[++i], 0, 10); }
+		else if (!strcmp(argv[i], "-cal") & _has_value) { _cal = strtol(argv[++i], 0, 10); }
+		else if (!strcmp(argv[i], "-t") & _has_value) { if (!pair(argv[++i], _hour, _mins)) { return usage(); } }
+		else if (!strcmp(argv[i], "-d") & _has_value) { if (!pair(argv[++i], _YY, _doty)) { return usage(); } }
+		else if (!strcmp(argv[i], "-leap") & _has_value) { if (!pair(argv[++i], _leap_YY, _leap_MM)) { return usage(); } }
+		else { return usage(); }
+	}
+
+	if ((_hour < 0) | (_hour > 23) | (_mins < 0) | (_mins > 59) | (_YY < 0) | (_YY > 99)
+		| (_doty < 1) | (_doty > 365 + wwvb_frame_is_leap_year((uint8_t)_YY))
+		| ((_dst != WWVB_DST_AUTO) & ((_dst < 0) | (_dst > 3)))
+		| (_dut1 < -9) | (_dut1 > 9) | (_leap_MM < 0) | (_leap_MM > 12) | (_leap_YY < 0) | (_leap_YY > 99)
+		| (_cal < -30000) | (_cal > 30000))
+	{
+		fprintf(stderr, "render_wav : out of range\n");
+		return 1;
+	}
+	if (_cfg.sample_rate == 0)
+	{
+		_cfg.sample_rate = _iq ? 8000 : 240000;
+	}
+
+	const wwvb_leap_second _leap[1] = { { (uint8_t)_leap_YY, (uint8_t)_leap_MM } };
+	uint8_t _DD, _MM;
+	from_day_of_the_year<uint8_t>((uint16_t)_doty, _DD, _MM, is_leap_year(2000 + _YY));
+	wwvb_tx.setup();
+	wwvb_tx.calibrate((int16_t)_cal, (int16_t)_cal);
+	wwvb_tx.setDUT1((int8_t)_dut1);
+	wwvb_tx.setLeapSecondSchedule(_leap, _leap_MM > 0);
+	wwvb_tx.set_time((uint8_t)_hour, (uint8_t)_mins, _DD, _MM, (uint8_t)_YY, (uint8_t)_dst);
+	wwvb_tx.start();
+	wwvb_render _render(wwvb_tx, _cfg);
+
+	FILE *_file = fopen(_path, "wb");
+	if (!_file)
+	{
+		fprintf(stderr, "render_wav : can't open %s\n", _path);
+		return 1;
+	}
+
+	const uint8_t _channels = _iq ? 2 : 1;
+	const uint32_t _n = _seconds * _cfg.sample_rate;
+	uint8_t _header[44];
+	wwvb_render::wav_header(_header, _cfg.sample_rate, _n, _channels);
+	bool _ok = (fwrite(_header, 1, sizeof(_header), _file) == sizeof(_header));
+
+	// one second per block
+	std::vector<int16_t> _block(_cfg.sample_rate * _channels);
+	std::vector<uint8_t> _bytes(2 * _block.size());
+	for (uint32_t s = 0; _ok & (s < _seconds); ++s)
+	{
+		if (_iq)
+		{
+			_render.render_iq(_block.data(), _cfg.sample_rate);
+		}
+		else
+		{
+			_render.render(_block.data(), _cfg.sample_rate);
+		}
+		// the wav samples are little endian
+		for (size_t k = 0; k < _block.size(); ++k)
+		{
+			const uint16_t _sample = (uint16_t)_block[k];
+			_bytes[2 * k] = _sample & 0xFF;
+			_bytes[2 * k + 1] = _sample >> 8;
+		}
+		_ok &= (fwrite(_bytes.data(), 1, _bytes.size(), _file) == _bytes.size());
+	}
+	_ok &= (fclose(_file) == 0);
+	if (!_ok)
+	{
+		fprintf(stderr, "render_wav : can't write %s\n", _path);
+		return 1;
+	}
+	printf("%s : %u s, %u Hz, %u channel(s)\n", _path, _seconds, _cfg.sample_rate, _channels);
+	return 0;
+}
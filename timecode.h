@@ -0,0 +1,311 @@
+#ifndef timecode_h
+#define timecode_h
+
+/*
+Generic time code transmitter (WWVB, DCF77, MSF, JJY)
+
+The timing core of wwvb.h (Timer1 phase & frequency correct PWM carrier, one isr tick per
+carrier period) driven by a frame format from timecode_formats.h, e.g.
+
+timecode<timecode_dcf77> dcf77_tx;
+ISR(TIMER1_OVF_vect) { dcf77_tx.interrupt_routine(); }
+
+* the carrier (ICR1) and the symbol edges (in isr ticks) are worked out from the format at compile time / in setup()
+* each minute is encoded into a table of symbols, one per second
+* the isr only counts ticks and looks up the next edge of the current symbol. The next minute is
+  encoded into a second table a symbol at a time (one each bit, see next_bit), and the tables are
+  swapped at the end of the frame - so the isr is short, never re-enables interrupts, and costs the
+  same for every format
+
+Time is set in the time base of the format (UTC for WWVB, CET/CEST for DCF77, UK time for MSF,
+JST for JJY). Set it before start() (or stop() first). DCF77 and MSF change between summer and
+winter time at 01:00 UTC (the EU rule), the hour before the clocks go back is taken as summer time.
+
+Note: this only supports PWM output (USE_OC1A or USE_OC1B) with a 16MHz or 8MHz ATmega,
+      wwvb.h is still needed for WWVB_PAM, WWVB_MODULATION_OUT, leap seconds and DUT1
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+
+// If not already defined, assume that we require TimeString and DateString conversion (see wwvb.h)
+#if !defined(REQUIRE_TIMEDATESTRING)
+#define REQUIRE_TIMEDATESTRING 1
+#endif
+
+#include <TimeDateTools.h>
+#include <timecode_formats.h>
+
+#if !(defined(USE_OC1A) | defined(USE_OC1B))
+#define USE_OC1A
+#endif
+
+template <typename FORMAT>
+class timecode
+{
+private:
+	// carrier : F_CPU / (2 * TOP), see wwvb::setup
+	static const uint16_t TOP = (F_CPU / 2 + FORMAT::carrier_Hz / 2) / FORMAT::carrier_Hz;
+	static const uint32_t TICKS_PER_SECOND = F_CPU / (2UL * TOP);
+
+	uint8_t PWM_LOW, PWM_HIGH;
+
+	// cumulative isr tick of each edge of each symbol : end of reduced, full, reduced, end of bit
+	uint32_t edges_[FORMAT::symbols][4];
+	int16_t calibration_;
+
+	// symbol tables : the frame being sent (front_) and the next frame
+	uint8_t symbols_[2][FORMAT::seconds];
+	volatile uint8_t front_;
+	uint8_t cursor_;     // position in FORMAT::layout() of the next second of the next frame to encode
+
+	timecode_time now_;  // the time encoded in the frame being sent
+	timecode_time next_; // the time encoded in the next frame
+	wwvb_dst_rule dst_rule_;
+	uint8_t dst_mode_;   // WWVB_DST_AUTO (use dst_rule_) or the daylight savings code to send
+
+	volatile uint32_t tick_;
+	volatile uint8_t phase_;
+	const uint32_t *bit_edges_;
+
+	volatile bool _is_active;
+
+	void set_edges()
+	{
+		const uint16_t (*_ms)[3] = FORMAT::symbol_ms();
+		const uint32_t _end = TICKS_PER_SECOND + calibration_;
+		for (uint8_t s = 0; s < FORMAT::symbols; ++s)
+		{
+			uint32_t _edge_ms = 0;
+			for (uint8_t e = 0; e < 3; ++e)
+			{
+				_edge_ms += _ms[s][e];
+				uint32_t _edge = _edge_ms * TICKS_PER_SECOND / 1000;
+				edges_[s][e] = (_edge < _end) ? _edge : _end;
+			}
+			edges_[s][3] = _end;
+		}
+	}
+
+	void set_level(const bool &_is_high)
+	{
+		digitalWrite(LED_BUILTIN, _is_high);
+#if defined(USE_OC1A)
+		OCR1A = _is_high ? PWM_HIGH : PWM_LOW;
+#elif defined(USE_OC1B)
+		OCR1B = _is_high ? PWM_HIGH : PWM_LOW;
+#endif
+	}
+
+	// phase 0 : reduced, 1 : full, 2 : reduced, 3 : full (zero length phases are skipped)
+	void start_bit()
+	{
+		tick_ = 0;
+		phase_ = 0;
+		bit_edges_ = edges_[symbols_[front_][frame_index]];
+		while ((phase_ < 3) & (bit_edges_[phase_] == 0))
+		{
+			++phase_;
+		}
+		set_level(phase_ & 0x01);
+	}
+
+	wwvb_dst_rule active_dst_rule()
+	{
+		return (dst_mode_ == WWVB_DST_AUTO) ? dst_rule_ : 0;
+	}
+
+	void next_bit()
+	{
+		if (++frame_index < FORMAT::seconds)
+		{
+			start_bit();
+			encode_next();
+			return;
+		}
+		frame_index = 0;
+		front_ ^= 1;
+		start_bit();
+
+		// Once a minute : step the time of the next frame
+		now_ = next_;
+		timecode_next_minute(next_, active_dst_rule(), FORMAT::dst_hour);
+		cursor_ = 0;
+	}
+
+	// Encode the next frame one symbol a bit (symbol n - 1 at bit n, and the last two at the last bit),
+	// so it is ready when the tables are swapped. The back table isnt sent until the next minute
+	void encode_next()
+	{
+		uint8_t *_back = symbols_[front_ ^ 1];
+		cursor_ = timecode_encode_second<FORMAT>(next_, _back, frame_index - 1, cursor_);
+		if (frame_index == FORMAT::seconds - 1)
+		{
+			cursor_ = timecode_encode_second<FORMAT>(next_, _back, frame_index, cursor_);
+		}
+	}
+
+public:
+	volatile uint8_t frame_index = 0;
+
+	timecode() : calibration_(0), front_(0), cursor_(0), dst_rule_(FORMAT::dst_rule), dst_mode_(WWVB_DST_AUTO), tick_(0), phase_(0),
+		bit_edges_(0), _is_active(false)
+	{
+		pinMode(LED_BUILTIN, OUTPUT);
+#if defined(USE_OC1A)
+		pinMode(9, OUTPUT);
+#elif defined(USE_OC1B)
+		pinMode(10, OUTPUT);
+#endif
+		set_time(0, 0, 1, 1, 0);
+	}
+
+	// add _ticks isr ticks to the end of each bit (see wwvb::calibrate)
+	void calibrate(const int16_t &_ticks)
+	{
+		calibration_ = _ticks;
+		set_edges();
+	}
+
+	void setup()
+	{
+		set_edges();
+
+		// Use Phase & Frequency correct PWM (see wwvb::setup)
+		TCCR1B = _BV(WGM13); // Mode 8: Phase & Frequency correct PWM
+		ICR1 = TOP;
+		PWM_HIGH = TOP / 2; // ~50% duty cycle
+		PWM_LOW = TOP / 22; // ~5% duty cycle
+
+#if defined(USE_OC1A)
+		TCCR1A = _BV(COM1A1); // Clear OC1A on compare match to OCR1A
+		OCR1A = PWM_HIGH;
+#elif defined(USE_OC1B)
+		TCCR1A = _BV(COM1B1); // Clear OC1B on compare match to OCR1B
+		OCR1B = PWM_HIGH;
+#endif
+		// enable interrupt on Timer1 overflow
+		TIMSK1 |= _BV(TOIE1);
+
+		frame_index = 0;
+
+		sei(); // enable interrupts
+	}
+
+	void setPWM_LOW(const uint8_t &_value)
+	{
+		PWM_LOW = (_value < TOP) ? _value : TOP;
+	}
+
+	void setPWM_HIGH(const uint8_t &_value)
+	{
+		PWM_HIGH = (_value < TOP) ? _value : TOP;
+	}
+
+	// the daylight savings rule used by set_time(.., WWVB_DST_AUTO), 0 - the rule of the format
+	void setDSTRule(const wwvb_dst_rule &_rule)
+	{
+		dst_rule_ = (_rule != 0) ? _rule : FORMAT::dst_rule;
+	}
+
+	// _daylight_savings : WWVB_DST_AUTO - use the daylight savings rule of the format (or setDSTRule)
+	//                     WWVB_DST_NO, WWVB_DST_ENDS, WWVB_DST_BEGINS, WWVB_DST_YES - send this code
+	//                     (the rule is kept for the next WWVB_DST_AUTO)
+	void set_time(const uint8_t &_hour, const uint8_t &_mins,
+		const uint8_t &_DD, const uint8_t &_MM, const uint8_t &_YY,
+		const uint8_t _daylight_savings = WWVB_DST_AUTO)
+	{
+		dst_mode_ = _daylight_savings;
+		const wwvb_dst_rule _rule = active_dst_rule();
+		timecode_set_time(now_, _hour, _mins, _DD, _MM, _YY, _daylight_savings, _rule, FORMAT::dst_hour);
+
+		// DCF77 and MSF send the time of the next minute marker
+		for (uint8_t i = 0; i < FORMAT::minute_offset; ++i)
+		{
+			timecode_next_minute(now_, _rule, FORMAT::dst_hour);
+		}
+		next_ = now_;
+		timecode_next_minute(next_, _rule, FORMAT::dst_hour);
+
+		timecode_encode_frame<FORMAT>(now_, symbols_[front_]);
+		timecode_encode_frame<FORMAT>(next_, symbols_[front_ ^ 1]);
+		cursor_ = 0;
+	}
+#if( REQUIRE_TIMEDATESTRING == 1)
+	void set_time(char dateString[], char timeString[], const uint8_t _daylight_savings = WWVB_DST_AUTO)
+	{
+		uint8_t _hour, _mins, _secs, _DD, _MM, _YY;
+
+		DateString_to_DDMMYY(dateString, _DD, _MM, _YY);
+		TimeString_to_HHMMSS(timeString, _hour, _mins, _secs);
+
+		set_time(_hour, _mins, _DD, _MM, _YY, _daylight_savings);
+	}
+#endif
+
+	// the time encoded in the frame being sent
+	uint8_t mm() { return now_.mm; }
+	uint8_t hh() { return now_.hh; }
+	uint8_t DD() { return now_.DD; }
+	uint8_t MM() { return now_.MM; }
+	uint8_t YY() { return now_.YY; }
+
+	// symbol sent at _frame_index (an index into FORMAT::symbol_ms)
+	uint8_t symbol(const uint8_t _frame_index)
+	{
+		return symbols_[front_][_frame_index];
+	}
+
+	void start()
+	{
+		frame_index = 0;
+		cursor_ = 0;
+		start_bit();
+
+		resume();
+	}
+	void stop()
+	{
+		_is_active = false;
+
+		// Set clock prescalar to 000 (STOP Timer/Clock)
+		TCCR1B &= ~_BV(CS12) & ~_BV(CS11) & ~_BV(CS10);
+	}
+	void resume()
+	{
+		_is_active = true;
+
+		// Set clock prescalar to 1 (16MHz or 8MHz - as per the base clock)
+		TCCR1B |= _BV(CS10);
+	}
+	bool is_active()
+	{
+		return _is_active;
+	}
+
+	void interrupt_routine()
+	{
+		//This routine is checked at each counter overflow - i.e. once per carrier period
+		if (++tick_ < bit_edges_[phase_])
+		{
+			return;
+		}
+		while ((phase_ < 3) & (tick_ >= bit_edges_[phase_]))
+		{
+			++phase_;
+		}
+		if (tick_ < bit_edges_[3])
+		{
+			set_level(phase_ & 0x01);
+			return;
+		}
+		next_bit();
+	}
+};
+
+#endif
@@ -0,0 +1,504 @@
+#ifndef timecode_formats_h
+#define timecode_formats_h
+
+/*
+Time code frame formats (WWVB, DCF77, MSF, JJY)
+
+A format is a struct of compile-time constants (see timecode_wwvb below):
+* carrier_Hz    : carrier frequency
+* seconds       : symbols per frame (one per second)
+* minute_offset : 0 - a frame is the time of the minute it is sent in (WWVB, JJY)
+                  1 - a frame is the time of the next minute marker (DCF77, MSF)
+* symbols       : number of symbol shapes
+* symbol_ms()   : the shape of each symbol : reduced carrier, full carrier, reduced carrier (ms),
+                  then full carrier to the end of the second
+* layout()      : the bit layout, a PROGMEM table of timecode_bit sorted by second and
+                  ended with TIMECODE_END
+* dst_rule()    : the daylight savings rule (see wwvb_dst.h)
+* dst_hour      : the hour (local standard time) the clocks go forward at, they go back at dst_hour + 1
+                  (summer time). TIMECODE_NO_DST_HOUR if the time sent doesnt change (WWVB sends UTC and
+                  the daylight savings code, JJY has no daylight savings)
+
+The layout describes where each BCD bit, parity bit and constant bit goes. The transmitter
+(timecode.h) only ever sees the per-minute table of symbols made from it, so the isr is the
+same whatever the format.
+
+Each timecode_bit sets bit 0 (or bit 1 with TIMECODE_B, for the MSF B bits) of the symbol for its
+second, unless it is a TIMECODE_MARKER, which sets the whole symbol to arg.
+
+ kind                 | arg                | arg2
+----------------------+--------------------+-------------------
+ TIMECODE_ONE         |                    |
+ TIMECODE_MARKER      | symbol             |
+ TIMECODE_MINS ...    | BCD weight (1-200) |
+ TIMECODE_PARITY_EVEN | first second       | last second  (bit 0 of each symbol)
+ TIMECODE_PARITY_ODD  | first second       | last second
+
+Note: there is no DUT1, leap second or (JJY) call sign support, these bits are sent as 0
+
+This has no Arduino dependencies so it can be used on the host.
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <wwvb_frame.h>
+#include <wwvb_dst.h>
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#endif
+#if !defined(PROGMEM)
+#define PROGMEM
+#endif
+#if !defined(memcpy_P)
+#define memcpy_P memcpy
+#endif
+
+// timecode_bit kinds
+#define TIMECODE_ONE 1
+#define TIMECODE_MARKER 2
+#define TIMECODE_MINS 3
+#define TIMECODE_HOUR 4
+#define TIMECODE_DAY 5
+#define TIMECODE_MONTH 6
+#define TIMECODE_YEAR 7
+#define TIMECODE_DOTY 8
+#define TIMECODE_DOW 9           // 0 - Sunday ... 6 - Saturday
+#define TIMECODE_DOW_ISO 10      // 1 - Monday ... 7 - Sunday
+#define TIMECODE_LEAP_YEAR 11
+#define TIMECODE_DST_AT_END 12   // daylight savings is in effect at 24:00 (WWVB MISC[7])
+#define TIMECODE_DST_AT_START 13 // daylight savings is in effect at 00:00 (WWVB MISC[8])
+#define TIMECODE_SUMMER 14       // daylight savings is in effect now
+#define TIMECODE_WINTER 15       // daylight savings is not in effect now
+#define TIMECODE_PARITY_EVEN 16
+#define TIMECODE_PARITY_ODD 17
+#define TIMECODE_B 0x80          // set bit 1 of the symbol (MSF B bits)
+
+#define TIMECODE_END { 0xFF, 0, 0, 0 }
+
+#define TIMECODE_NO_DST_HOUR 0xFF
+
+struct timecode_bit
+{
+	uint8_t second;
+	uint8_t kind;
+	uint8_t arg;
+	uint8_t arg2;
+};
+
+// the time being encoded
+struct timecode_time
+{
+	uint8_t hh, mm;     // 00-23, 00-59
+	uint8_t DD, MM, YY; // 1-31, 1-12, 00-99
+	uint16_t doty;      // 1-366
+	uint8_t dow;        // 0 - Sunday ... 6 - Saturday
+	uint8_t dst;        // daylight savings code (see wwvb_dst.h)
+	uint8_t summer;     // daylight savings is in effect now
+};
+
+// set DD, MM and dow from doty and YY
+inline void timecode_set_date(timecode_time &_t)
+{
+	static const uint16_t month_start[13] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365 };
+	const bool _leap = wwvb_frame_is_leap_year(_t.YY);
+
+	uint8_t _MM = 1;
+	while ((_MM < 12) & (_t.doty > month_start[_MM] + ((_MM > 1) & _leap)))
+	{
+		++_MM;
+	}
+	_t.MM = _MM;
+	_t.DD = _t.doty - month_start[_MM - 1] - ((_MM > 2) & _leap);
+	_t.dow = wwvb_day_of_week(_t.YY, _t.doty);
+}
+
+// daylight savings is in effect at hh:mm (local time), the clocks change at _dst_hour (see dst_hour above).
+// The hour before the clocks go back is sent twice, it is taken as summer time
+inline uint8_t timecode_summer_time(const timecode_time &_t, const uint8_t _dst_hour)
+{
+	switch (_t.dst)
+	{
+	case WWVB_DST_YES:
+		return 1;
+	case WWVB_DST_BEGINS:
+		return (_dst_hour != TIMECODE_NO_DST_HOUR) & (_t.hh > _dst_hour);
+	case WWVB_DST_ENDS:
+		return (_dst_hour != TIMECODE_NO_DST_HOUR) & (_t.hh <= _dst_hour);
+	default:
+		return 0;
+	}
+}
+
+// set the time, _rule (if not 0) works out the daylight savings code
+inline void timecode_set_time(timecode_time &_t, const uint8_t &_hour, const uint8_t &_mins,
+	const uint8_t &_DD, const uint8_t &_MM, const uint8_t &_YY, const uint8_t &_dst, const wwvb_dst_rule &_rule,
+	const uint8_t _dst_hour)
+{
+	static const uint16_t month_start[12] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+	_t.hh = _hour;
+	_t.mm = _mins;
+	_t.YY = _YY;
+	_t.doty = month_start[_MM - 1] + _DD + ((_MM > 2) & wwvb_frame_is_leap_year(_YY));
+	timecode_set_date(_t);
+	_t.dst = (_rule != 0) ? _rule(_t.YY, _t.doty) : _dst;
+	_t.summer = timecode_summer_time(_t, _dst_hour);
+}
+
+// step the time on by one minute, the daylight savings code is worked out (by _rule) when the day changes.
+// On the days the clocks change (_dst_hour, see dst_hour above) the time jumps :
+// e.g. DCF77 (EU, 01:00 UTC) 01:59 CET -> 03:00 CEST, and 02:59 CEST -> 02:00 CET
+inline void timecode_next_minute(timecode_time &_t, const wwvb_dst_rule &_rule, const uint8_t _dst_hour)
+{
+	if (wwvb_next_minute(_t.hh, _t.mm, _t.doty, _t.YY) == 2)
+	{
+		timecode_set_date(_t);
+		if (_rule != 0)
+		{
+			_t.dst = _rule(_t.YY, _t.doty);
+		}
+		_t.summer = timecode_summer_time(_t, _dst_hour);
+	}
+	else if ((_t.mm == 0) & (_dst_hour != TIMECODE_NO_DST_HOUR))
+	{
+		if ((_t.dst == WWVB_DST_BEGINS) & !_t.summer & (_t.hh == _dst_hour))
+		{
+			_t.hh = _dst_hour + 1;
+			_t.summer = 1;
+		}
+		else if ((_t.dst == WWVB_DST_ENDS) & _t.summer & (_t.hh == _dst_hour + 1))
+		{
+			_t.hh = _dst_hour;
+			_t.summer = 0;
+		}
+	}
+}
+
+// bit of _value with BCD weight _weight (1, 2, 4, 8, 10, 20, 40, 80, 100, 200)
+inline uint8_t timecode_bcd(const uint16_t &_value, const uint8_t &_weight)
+{
+	if (_weight >= 100)
+	{
+		return ((_value / 100) & (_weight / 100)) != 0;
+	}
+	if (_weight >= 10)
+	{
+		return (((_value / 10) % 10) & (_weight / 10)) != 0;
+	}
+	return ((_value % 10) & _weight) != 0;
+}
+
+// value of one data bit, _symbols holds the (already encoded) earlier seconds of the frame
+inline uint8_t timecode_value(const timecode_time &_t, const timecode_bit &_bit, const uint8_t *_symbols)
+{
+	switch (_bit.kind & ~TIMECODE_B)
+	{
+	case TIMECODE_ONE:
+		return 1;
+	case TIMECODE_MINS:
+		return timecode_bcd(_t.mm, _bit.arg);
+	case TIMECODE_HOUR:
+		return timecode_bcd(_t.hh, _bit.arg);
+	case TIMECODE_DAY:
+		return timecode_bcd(_t.DD, _bit.arg);
+	case TIMECODE_MONTH:
+		return timecode_bcd(_t.MM, _bit.arg);
+	case TIMECODE_YEAR:
+		return timecode_bcd(_t.YY, _bit.arg);
+	case TIMECODE_DOTY:
+		return timecode_bcd(_t.doty, _bit.arg);
+	case TIMECODE_DOW:
+		return timecode_bcd(_t.dow, _bit.arg);
+	case TIMECODE_DOW_ISO:
+		return timecode_bcd((_t.dow == 0) ? 7 : _t.dow, _bit.arg);
+	case TIMECODE_LEAP_YEAR:
+		return wwvb_frame_is_leap_year(_t.YY);
+	case TIMECODE_DST_AT_END:
+		return (_t.dst >> 1) & 0x01;
+	case TIMECODE_DST_AT_START:
+		return _t.dst & 0x01;
+	case TIMECODE_SUMMER:
+		return _t.summer;
+	case TIMECODE_WINTER:
+		return !_t.summer;
+	case TIMECODE_PARITY_EVEN:
+	case TIMECODE_PARITY_ODD:
+	{
+		uint8_t _parity = ((_bit.kind & ~TIMECODE_B) == TIMECODE_PARITY_ODD);
+		for (uint8_t s = _bit.arg; s <= _bit.arg2; ++s)
+		{
+			_parity ^= _symbols[s] & 0x01;
+		}
+		return _parity;
+	}
+	default:
+		return 0;
+	}
+}
+
+// Encode the symbol for _second, _cursor is the position in the layout (0 for second 0)
+// returns the position in the layout for the next second
+template <typename FORMAT>
+inline uint8_t timecode_encode_second(const timecode_time &_t, uint8_t *_symbols, const uint8_t _second, uint8_t _cursor)
+{
+	const timecode_bit *_layout = FORMAT::layout();
+	uint8_t _symbol = 0;
+	timecode_bit _bit;
+	for (;; ++_cursor)
+	{
+		memcpy_P(&_bit, _layout + _cursor, sizeof(timecode_bit));
+		if (_bit.second > _second) // includes TIMECODE_END
+		{
+			break;
+		}
+		if (_bit.second < _second)
+		{
+			continue;
+		}
+
+		if (_bit.kind == TIMECODE_MARKER)
+		{
+			_symbol = _bit.arg;
+		}
+		else
+		{
+			_symbol |= timecode_value(_t, _bit, _symbols) << (_bit.kind >> 7);
+		}
+	}
+	_symbols[_second] = _symbol;
+	return _cursor;
+}
+
+// Encode a whole frame (FORMAT::seconds symbols)
+template <typename FORMAT>
+inline void timecode_encode_frame(const timecode_time &_t, uint8_t *_symbols)
+{
+	uint8_t _cursor = 0;
+	for (uint8_t s = 0; s < FORMAT::seconds; ++s)
+	{
+		_cursor = timecode_encode_second<FORMAT>(_t, _symbols, s, _cursor);
+	}
+}
+
+/*
+WWVB : 60kHz, UTC, reduced carrier for 0.2s (0), 0.5s (1), 0.8s (marker)
+        0   1   2   3   4   5   6   7   8   9
+MINS    M  40  20  10   0   8   4   2   1   M
+HOUR    -   -  20  10   0   8   4   2   1   M
+DOTY    -   - 200 100   0  80  40  20  10   M
+DUT1    8   4   2   1   -   -   +   -   +   M
+YEAR  0.8 0.4 0.2 0.1   -  80  40  20  10   M
+MISC    8   4   2   1   - LYI LSW   2   1   M
+*/
+struct timecode_wwvb
+{
+	static const uint32_t carrier_Hz = 60000;
+	static const uint8_t seconds = 60;
+	static const uint8_t minute_offset = 0;
+	static const uint8_t dst_hour = TIMECODE_NO_DST_HOUR;
+	static const uint8_t symbols = 3;
+
+	static const uint16_t (*symbol_ms())[3]
+	{
+		static const uint16_t _ms[symbols][3] = { { 200, 0, 0 }, { 500, 0, 0 }, { 800, 0, 0 } };
+		return _ms;
+	}
+	static const timecode_bit *layout()
+	{
+		static const timecode_bit _layout[] PROGMEM = {
+			{ 0, TIMECODE_MARKER, 2, 0 },
+			{ 1, TIMECODE_MINS, 40, 0 }, { 2, TIMECODE_MINS, 20, 0 }, { 3, TIMECODE_MINS, 10, 0 },
+			{ 5, TIMECODE_MINS, 8, 0 }, { 6, TIMECODE_MINS, 4, 0 }, { 7, TIMECODE_MINS, 2, 0 }, { 8, TIMECODE_MINS, 1, 0 },
+			{ 9, TIMECODE_MARKER, 2, 0 },
+			{ 12, TIMECODE_HOUR, 20, 0 }, { 13, TIMECODE_HOUR, 10, 0 },
+			{ 15, TIMECODE_HOUR, 8, 0 }, { 16, TIMECODE_HOUR, 4, 0 }, { 17, TIMECODE_HOUR, 2, 0 }, { 18, TIMECODE_HOUR, 1, 0 },
+			{ 19, TIMECODE_MARKER, 2, 0 },
+			{ 22, TIMECODE_DOTY, 200, 0 }, { 23, TIMECODE_DOTY, 100, 0 },
+			{ 25, TIMECODE_DOTY, 80, 0 }, { 26, TIMECODE_DOTY, 40, 0 }, { 27, TIMECODE_DOTY, 20, 0 }, { 28, TIMECODE_DOTY, 10, 0 },
+			{ 29, TIMECODE_MARKER, 2, 0 },
+			{ 30, TIMECODE_DOTY, 8, 0 }, { 31, TIMECODE_DOTY, 4, 0 }, { 32, TIMECODE_DOTY, 2, 0 }, { 33, TIMECODE_DOTY, 1, 0 },
+			{ 36, TIMECODE_ONE, 0, 0 }, { 38, TIMECODE_ONE, 0, 0 }, // DUT1 = +0.0
+			{ 39, TIMECODE_MARKER, 2, 0 },
+			{ 45, TIMECODE_YEAR, 80, 0 }, { 46, TIMECODE_YEAR, 40, 0 }, { 47, TIMECODE_YEAR, 20, 0 }, { 48, TIMECODE_YEAR, 10, 0 },
+			{ 49, TIMECODE_MARKER, 2, 0 },
+			{ 50, TIMECODE_YEAR, 8, 0 }, { 51, TIMECODE_YEAR, 4, 0 }, { 52, TIMECODE_YEAR, 2, 0 }, { 53, TIMECODE_YEAR, 1, 0 },
+			{ 55, TIMECODE_LEAP_YEAR, 0, 0 },
+			{ 57, TIMECODE_DST_AT_END, 0, 0 }, { 58, TIMECODE_DST_AT_START, 0, 0 },
+			{ 59, TIMECODE_MARKER, 2, 0 },
+			TIMECODE_END };
+		return _layout;
+	}
+	static uint8_t dst_rule(const uint8_t &_YY, const uint16_t &_doty)
+	{
+		return wwvb_dst_us(_YY, _doty);
+	}
+};
+
+/*
+DCF77 : 77.5kHz, CET/CEST, reduced carrier for 0.1s (0), 0.2s (1), no reduction at second 59 (marker)
+second 17 CEST, 18 CET, 20 start of time (1)
+21-27 minute (1 2 4 8 10 20 40), 28 even parity
+29-34 hour (1 2 4 8 10 20), 35 even parity
+36-41 day (1 2 4 8 10 20), 42-44 day of the week (1 - Monday), 45-49 month (1 2 4 8 10),
+50-57 year (1 2 4 8 10 20 40 80), 58 even parity of 36-57
+Note: 16MHz / (2 * 103) = 77670Hz, which may be outside the bandwidth of some (crystal filter) receivers
+*/
+struct timecode_dcf77
+{
+	static const uint32_t carrier_Hz = 77500;
+	static const uint8_t seconds = 60;
+	static const uint8_t minute_offset = 1;
+	static const uint8_t dst_hour = 2; // EU : 01:00 UTC = 02:00 CET -> 03:00 CEST, 03:00 CEST -> 02:00 CET
+	static const uint8_t symbols = 3;
+
+	static const uint16_t (*symbol_ms())[3]
+	{
+		static const uint16_t _ms[symbols][3] = { { 100, 0, 0 }, { 200, 0, 0 }, { 0, 0, 0 } };
+		return _ms;
+	}
+	static const timecode_bit *layout()
+	{
+		static const timecode_bit _layout[] PROGMEM = {
+			{ 17, TIMECODE_SUMMER, 0, 0 }, { 18, TIMECODE_WINTER, 0, 0 },
+			{ 20, TIMECODE_ONE, 0, 0 },
+			{ 21, TIMECODE_MINS, 1, 0 }, { 22, TIMECODE_MINS, 2, 0 }, { 23, TIMECODE_MINS, 4, 0 }, { 24, TIMECODE_MINS, 8, 0 },
+			{ 25, TIMECODE_MINS, 10, 0 }, { 26, TIMECODE_MINS, 20, 0 }, { 27, TIMECODE_MINS, 40, 0 },
+			{ 28, TIMECODE_PARITY_EVEN, 21, 27 },
+			{ 29, TIMECODE_HOUR, 1, 0 }, { 30, TIMECODE_HOUR, 2, 0 }, { 31, TIMECODE_HOUR, 4, 0 }, { 32, TIMECODE_HOUR, 8, 0 },
+			{ 33, TIMECODE_HOUR, 10, 0 }, { 34, TIMECODE_HOUR, 20, 0 },
+			{ 35, TIMECODE_PARITY_EVEN, 29, 34 },
+			{ 36, TIMECODE_DAY, 1, 0 }, { 37, TIMECODE_DAY, 2, 0 }, { 38, TIMECODE_DAY, 4, 0 }, { 39, TIMECODE_DAY, 8, 0 },
+			{ 40, TIMECODE_DAY, 10, 0 }, { 41, TIMECODE_DAY, 20, 0 },
+			{ 42, TIMECODE_DOW_ISO, 1, 0 }, { 43, TIMECODE_DOW_ISO, 2, 0 }, { 44, TIMECODE_DOW_ISO, 4, 0 },
+			{ 45, TIMECODE_MONTH, 1, 0 }, { 46, TIMECODE_MONTH, 2, 0 }, { 47, TIMECODE_MONTH, 4, 0 }, { 48, TIMECODE_MONTH, 8, 0 },
+			{ 49, TIMECODE_MONTH, 10, 0 },
+			{ 50, TIMECODE_YEAR, 1, 0 }, { 51, TIMECODE_YEAR, 2, 0 }, { 52, TIMECODE_YEAR, 4, 0 }, { 53, TIMECODE_YEAR, 8, 0 },
+			{ 54, TIMECODE_YEAR, 10, 0 }, { 55, TIMECODE_YEAR, 20, 0 }, { 56, TIMECODE_YEAR, 40, 0 }, { 57, TIMECODE_YEAR, 80, 0 },
+			{ 58, TIMECODE_PARITY_EVEN, 36, 57 },
+			{ 59, TIMECODE_MARKER, 2, 0 },
+			TIMECODE_END };
+		return _layout;
+	}
+	static uint8_t dst_rule(const uint8_t &_YY, const uint16_t &_doty)
+	{
+		return wwvb_dst_eu(_YY, _doty);
+	}
+};
+
+/*
+MSF : 60kHz, UK time, carrier off for 0.5s (minute marker) at second 0,
+then 0.1s (A = 0, B = 0), 0.2s (A = 1, B = 0), 0.3s (A = 1, B = 1), or 0.1s off, 0.1s on, 0.1s off (A = 0, B = 1)
+A : 17-24 year (80 ... 1), 25-29 month (10 8 4 2 1), 30-35 day (20 10 8 4 2 1),
+    36-38 day of the week (4 2 1, 0 - Sunday), 39-44 hour (20 10 8 4 2 1), 45-51 minute (40 ... 1), 52-59 01111110
+B : 54 - 57 odd parity of A 17-24, 25-35, 36-38, 39-51, 58 British Summer Time
+*/
+struct timecode_msf
+{
+	static const uint32_t carrier_Hz = 60000;
+	static const uint8_t seconds = 60;
+	static const uint8_t minute_offset = 1;
+	static const uint8_t dst_hour = 1; // EU : 01:00 UTC = 01:00 GMT -> 02:00 BST, 02:00 BST -> 01:00 GMT
+	static const uint8_t symbols = 5;
+
+	static const uint16_t (*symbol_ms())[3]
+	{
+		static const uint16_t _ms[symbols][3] = { { 100, 0, 0 }, { 200, 0, 0 }, { 100, 100, 100 }, { 300, 0, 0 }, { 500, 0, 0 } };
+		return _ms;
+	}
+	static const timecode_bit *layout()
+	{
+		static const timecode_bit _layout[] PROGMEM = {
+			{ 0, TIMECODE_MARKER, 4, 0 },
+			{ 17, TIMECODE_YEAR, 80, 0 }, { 18, TIMECODE_YEAR, 40, 0 }, { 19, TIMECODE_YEAR, 20, 0 }, { 20, TIMECODE_YEAR, 10, 0 },
+			{ 21, TIMECODE_YEAR, 8, 0 }, { 22, TIMECODE_YEAR, 4, 0 }, { 23, TIMECODE_YEAR, 2, 0 }, { 24, TIMECODE_YEAR, 1, 0 },
+			{ 25, TIMECODE_MONTH, 10, 0 }, { 26, TIMECODE_MONTH, 8, 0 }, { 27, TIMECODE_MONTH, 4, 0 }, { 28, TIMECODE_MONTH, 2, 0 },
+			{ 29, TIMECODE_MONTH, 1, 0 },
+			{ 30, TIMECODE_DAY, 20, 0 }, { 31, TIMECODE_DAY, 10, 0 }, { 32, TIMECODE_DAY, 8, 0 }, { 33, TIMECODE_DAY, 4, 0 },
+			{ 34, TIMECODE_DAY, 2, 0 }, { 35, TIMECODE_DAY, 1, 0 },
+			{ 36, TIMECODE_DOW, 4, 0 }, { 37, TIMECODE_DOW, 2, 0 }, { 38, TIMECODE_DOW, 1, 0 },
+			{ 39, TIMECODE_HOUR, 20, 0 }, { 40, TIMECODE_HOUR, 10, 0 }, { 41, TIMECODE_HOUR, 8, 0 }, { 42, TIMECODE_HOUR, 4, 0 },
+			{ 43, TIMECODE_HOUR, 2, 0 }, { 44, TIMECODE_HOUR, 1, 0 },
+			{ 45, TIMECODE_MINS, 40, 0 }, { 46, TIMECODE_MINS, 20, 0 }, { 47, TIMECODE_MINS, 10, 0 }, { 48, TIMECODE_MINS, 8, 0 },
+			{ 49, TIMECODE_MINS, 4, 0 }, { 50, TIMECODE_MINS, 2, 0 }, { 51, TIMECODE_MINS, 1, 0 },
+			{ 53, TIMECODE_ONE, 0, 0 },
+			{ 54, TIMECODE_ONE, 0, 0 }, { 54, TIMECODE_PARITY_ODD | TIMECODE_B, 17, 24 },
+			{ 55, TIMECODE_ONE, 0, 0 }, { 55, TIMECODE_PARITY_ODD | TIMECODE_B, 25, 35 },
+			{ 56, TIMECODE_ONE, 0, 0 }, { 56, TIMECODE_PARITY_ODD | TIMECODE_B, 36, 38 },
+			{ 57, TIMECODE_ONE, 0, 0 }, { 57, TIMECODE_PARITY_ODD | TIMECODE_B, 39, 51 },
+			{ 58, TIMECODE_ONE, 0, 0 }, { 58, TIMECODE_SUMMER | TIMECODE_B, 0, 0 },
+			TIMECODE_END };
+		return _layout;
+	}
+	static uint8_t dst_rule(const uint8_t &_YY, const uint16_t &_doty)
+	{
+		return wwvb_dst_eu(_YY, _doty);
+	}
+};
+
+/*
+JJY : 40kHz (Fukushima) or 60kHz (timecode_jjy60, Kyushu), JST, full carrier for 0.8s (0), 0.5s (1), 0.2s (marker)
+then reduced carrier to the end of the second
+        0   1   2   3   4   5   6   7   8   9
+ 0      M  40  20  10   0   8   4   2   1   M
+10      -   -  20  10   0   8   4   2   1   M  (hour)
+20      -   - 200 100   0  80  40  20  10   M  (doty)
+30      8   4   2   1   -   - PA1 PA2   0   M  (PA1 : even parity of the hour, PA2 : of the minute)
+40      0  80  40  20  10   8   4   2   1   M  (year)
+50      4   2   1   0   0   -   -   -   -   M  (day of the week, 0 - Sunday)
+Note: the call sign (minutes 15 and 45) is not sent
+*/
+struct timecode_jjy
+{
+	static const uint32_t carrier_Hz = 40000;
+	static const uint8_t seconds = 60;
+	static const uint8_t minute_offset = 0;
+	static const uint8_t dst_hour = TIMECODE_NO_DST_HOUR;
+	static const uint8_t symbols = 3;
+
+	static const uint16_t (*symbol_ms())[3]
+	{
+		static const uint16_t _ms[symbols][3] = { { 0, 800, 200 }, { 0, 500, 500 }, { 0, 200, 800 } };
+		return _ms;
+	}
+	static const timecode_bit *layout()
+	{
+		static const timecode_bit _layout[] PROGMEM = {
+			{ 0, TIMECODE_MARKER, 2, 0 },
+			{ 1, TIMECODE_MINS, 40, 0 }, { 2, TIMECODE_MINS, 20, 0 }, { 3, TIMECODE_MINS, 10, 0 },
+			{ 5, TIMECODE_MINS, 8, 0 }, { 6, TIMECODE_MINS, 4, 0 }, { 7, TIMECODE_MINS, 2, 0 }, { 8, TIMECODE_MINS, 1, 0 },
+			{ 9, TIMECODE_MARKER, 2, 0 },
+			{ 12, TIMECODE_HOUR, 20, 0 }, { 13, TIMECODE_HOUR, 10, 0 },
+			{ 15, TIMECODE_HOUR, 8, 0 }, { 16, TIMECODE_HOUR, 4, 0 }, { 17, TIMECODE_HOUR, 2, 0 }, { 18, TIMECODE_HOUR, 1, 0 },
+			{ 19, TIMECODE_MARKER, 2, 0 },
+			{ 22, TIMECODE_DOTY, 200, 0 }, { 23, TIMECODE_DOTY, 100, 0 },
+			{ 25, TIMECODE_DOTY, 80, 0 }, { 26, TIMECODE_DOTY, 40, 0 }, { 27, TIMECODE_DOTY, 20, 0 }, { 28, TIMECODE_DOTY, 10, 0 },
+			{ 29, TIMECODE_MARKER, 2, 0 },
+			{ 30, TIMECODE_DOTY, 8, 0 }, { 31, TIMECODE_DOTY, 4, 0 }, { 32, TIMECODE_DOTY, 2, 0 }, { 33, TIMECODE_DOTY, 1, 0 },
+			{ 36, TIMECODE_PARITY_EVEN, 12, 18 }, { 37, TIMECODE_PARITY_EVEN, 1, 8 },
+			{ 39, TIMECODE_MARKER, 2, 0 },
+			{ 41, TIMECODE_YEAR, 80, 0 }, { 42, TIMECODE_YEAR, 40, 0 }, { 43, TIMECODE_YEAR, 20, 0 }, { 44, TIMECODE_YEAR, 10, 0 },
+			{ 45, TIMECODE_YEAR, 8, 0 }, { 46, TIMECODE_YEAR, 4, 0 }, { 47, TIMECODE_YEAR, 2, 0 }, { 48, TIMECODE_YEAR, 1, 0 },
+			{ 49, TIMECODE_MARKER, 2, 0 },
+			{ 50, TIMECODE_DOW, 4, 0 }, { 51, TIMECODE_DOW, 2, 0 }, { 52, TIMECODE_DOW, 1, 0 },
+			{ 59, TIMECODE_MARKER, 2, 0 },
+			TIMECODE_END };
+		return _layout;
+	}
+	static uint8_t dst_rule(const uint8_t &_YY, const uint16_t &_doty)
+	{
+		return wwvb_dst_none(_YY, _doty);
+	}
+};
+
+struct timecode_jjy60 : public timecode_jjy
+{
+	static const uint32_t carrier_Hz = 60000;
+};
+
+#endif
@@ -4,6 +4,9 @@
 // None - PWM modulated output on D9
 // WWVB_MODULATION_OUT - modulation out of D9
 // WWVB_PAM - Carrier output on D9, Modulation output on D10
+// WWVB_PM - also phase modulate (BPSK) the carrier, see wwvb_pm.h
+// WWVB_LOW_POWER - idle sleep between interrupts, see wwvb::idle
+// WWVB_TELEMETRY - raw() and debug_time() record binary telemetry instead of printing, see wwvb_telemetry.h
 /*
 Designed for the ATtiny85 @ 16MHz / 5V
 ( but works on the ATmega328p and ATmega32u4 )
@@ -41,6 +44,10 @@ License: MIT license (see LICENSE file).
 #define REQUIRE_TIMEDATESTRING 1
 #endif
 
+#if defined(WWVB_MODULATION_OUT) & defined(WWVB_PM)
+#pragma message("ERROR : WWVB_PM needs the carrier, it cant be used with WWVB_MODULATION_OUT")
+#endif
+
 #if defined(WWVB_MODULATION_OUT)
 #if (F_CPU != 16000000)
 //#error "Currently only 16MHz ATmega328p and ATmega32u4 boards are supported for external AM"
@@ -55,6 +62,14 @@ License: MIT license (see LICENSE file).
 #define WWVB_EOB_ms 1000
 #endif
 
+// Time warp : the bit timing (and calibration) is divided by WWVB_TIMEWARP so that frames are sent
+// faster than real time, e.g. 100 -> 10ms bits, 0.6s frames
+// This is for checking leap years, year rollover etc. against a reference calendar
+// (see examples/time_warp), a real clock wont decode it
+#if !defined(WWVB_TIMEWARP)
+#define WWVB_TIMEWARP 1
+#endif
+
 /*
 Default ATtiny85 to use OC1B as OC1A uses an SPI pin - you may want to use SPI and wwvb
 
@@ -103,6 +118,35 @@ WWVB_OUT |--(p0)--[110R]--(p1)--[1uF]--|GND
 #endif
 
 #include <TimeDateTools.h>
+#include <wwvb_dst.h>
+#include <wwvb_frame.h>
+#if defined(WWVB_PM)
+#include <wwvb_pm.h>
+#endif
+#if defined(WWVB_LOW_POWER)
+#include <avr/sleep.h>
+#endif
+#if defined(WWVB_TELEMETRY)
+#include <wwvb_telemetry.h>
+#endif
+
+// DUT1 (UT1 - UTC) is in tenths of a second : -9 (-0.9s) to +9 (+0.9s)
+#define WWVB_DUT1_ERROR -128
+
+// DUT1 schedule entry : dut1 tenths of a second from 00:00 UTC on day doty of 20YY
+struct wwvb_dut1_step
+{
+	uint8_t YY;
+	uint16_t doty;
+	int8_t dut1;
+};
+
+// leap second schedule entry : a leap second (23:59:60 UTC) at the end of the last day of month MM of 20YY
+struct wwvb_leap_second
+{
+	uint8_t YY;
+	uint8_t MM;
+};
 
 // wwvb class - note, you will need to specify the interrupt routine in your main sketch
 class wwvb
@@ -126,6 +170,30 @@ private:
 	volatile bool is_leap_year_;
 	volatile uint8_t daylight_savings_; // 00 - no, 10 - starts today, 11 - yes, 01 - ends today
 
+	// daylight savings rule and mode (WWVB_DST_AUTO or a fixed code)
+	wwvb_dst_rule dst_rule_;
+	uint8_t dst_mode_;
+
+	// DUT1 (tenths of a second) before the first schedule entry, and the DUT1 and leap second schedules
+	int8_t dut1_;
+	const wwvb_dut1_step *dut1_schedule_;
+	uint8_t dut1_count_;
+	const wwvb_leap_second *leap_schedule_;
+	uint8_t leap_count_;
+	volatile bool is_leap_day_;    // a leap second is inserted at the end of today
+	volatile bool is_leap_minute_; // this minute (23:59 UTC) has 61 seconds
+
+	// the day that daylight savings, DUT1 and the leap second were last worked out for
+	volatile uint16_t daily_doty_;
+	volatile uint8_t daily_YY_;
+
+#if defined(WWVB_PM)
+	// phase modulation frame, and the minute it was worked out for
+	volatile uint64_t pm_frame_ = 0;
+	volatile uint8_t pm_mins_ = 0xFF;
+	volatile uint8_t pm_dst_next_ = WWVB_PM_DST_NEXT_OTHER; // the daylight savings schedule (see wwvb_pm_dst_next)
+#endif
+
 	// LOW :   Low for 0.2s / 1.0s (20% low duty cycle)
 	// HIGH:   Low for 0.5s / 1.0s
 	// MARKER: Low for 0.8s / 1.0s
@@ -167,10 +235,44 @@ private:
 	
 	volatile bool _is_active = false;
 	volatile bool _is_odd_bit = true;
+
+#if defined(WWVB_LOW_POWER)
+	// isr ticks where the application was idle (asleep) / awake, see idle()
+	volatile bool _is_idle = false;
+	volatile uint32_t asleep_ticks = 0;
+	volatile uint32_t awake_ticks = 0;
+#endif
+#if defined(WWVB_TELEMETRY)
+	// odd while the isr (or set_time) is changing the time and frame, see snapshot()
+	volatile uint8_t frame_seq_ = 0;
+
+	// Copy the time and frame into a telemetry payload (_time : hour, mins, DD, MM, YY first, then the frame)
+	// The frame takes ~100us to read, too long to hold off the isr, so the copy is retried if the time
+	// changed while it was being made (a sequence counter) - a record is never half of one minute and half of the next
+	void snapshot(uint8_t *_payload, const bool &_time)
+	{
+		uint8_t _seq;
+		do
+		{
+			_seq = frame_seq_;
+			if (_time)
+			{
+				_payload[0] = hour_; _payload[1] = mins_; _payload[2] = DD_; _payload[3] = MM_; _payload[4] = YY_;
+			}
+			wwvb_telemetry_pack_frame(_payload + (_time ? 5 : 0), frame());
+		} while ((_seq & 0x01) | (_seq != frame_seq_));
+	}
+#endif
 public:
 	volatile uint8_t frame_index = 0;
+#if defined(WWVB_TELEMETRY)
+	wwvb_telemetry telemetry; // send it with telemetry.service(Serial) in loop()
+#endif
 
-	wwvb() : timezone_HH(0), timezone_MM(0), is_leap_year_(0), daylight_savings_(0)
+	wwvb() : timezone_HH(0), timezone_MM(0), is_leap_year_(0), daylight_savings_(0),
+		dst_rule_(wwvb_dst_us), dst_mode_(WWVB_DST_NO),
+		dut1_(0), dut1_schedule_(0), dut1_count_(0), leap_schedule_(0), leap_count_(0),
+		is_leap_day_(0), is_leap_minute_(0), daily_doty_(0), daily_YY_(0)
 	{
 		pinMode(LED_BUILTIN, OUTPUT);
 		// Set the carrier and modulation pins to output
@@ -216,16 +318,21 @@ public:
 
 	void calibrate(const int16_t &_c0, const int16_t &_c1)
 	{
-		WWVB_EOB_CAL[0] = _c0;
-		WWVB_EOB_CAL[1] = _c1;
+		WWVB_EOB_CAL[0] = _c0 / WWVB_TIMEWARP;
+		WWVB_EOB_CAL[1] = _c1 / WWVB_TIMEWARP;
+	}
+	void getCalibration(int16_t &_c0, int16_t &_c1)
+	{
+		_c0 = WWVB_EOB_CAL[0] * WWVB_TIMEWARP;
+		_c1 = WWVB_EOB_CAL[1] * WWVB_TIMEWARP;
 	}
 
 	void set(const uint16_t &_low, const uint16_t &_high, const uint16_t &_marker, const uint16_t &_eob)
 	{
-		WWVB_LOW = _low;
-		WWVB_HIGH = _high;
-		WWVB_MARKER = _marker;
-		WWVB_ENDOFBIT = _eob;
+		WWVB_LOW = _low / WWVB_TIMEWARP;
+		WWVB_HIGH = _high / WWVB_TIMEWARP;
+		WWVB_MARKER = _marker / WWVB_TIMEWARP;
+		WWVB_ENDOFBIT = _eob / WWVB_TIMEWARP;
 
 		pulse_width[0] = WWVB_LOW;
 		pulse_width[1] = WWVB_HIGH;
@@ -234,7 +341,11 @@ public:
 
 	void raw()
 	{
-#if (_DEBUG > 0)
+#if defined(WWVB_TELEMETRY)
+		uint8_t _payload[WWVB_TLM_RAW_SIZE];
+		snapshot(_payload, false);
+		telemetry.record(WWVB_TLM_RAW, _payload, WWVB_TLM_RAW_SIZE);
+#elif (_DEBUG > 0)
 		for (uint8_t fI = 0; fI < 60; ++fI)
 		{
 			uint8_t sI = fI % 10;
@@ -440,7 +551,7 @@ public:
 		frame_index = 0;
 		subframe_index = 0;
 		isr_count = 0;
-		set_dut1(); // This isnt set again - dut1 is unused (but still sent)
+		set_dut1(dut1_); // updated daily by set_time / add_time (see setDUT1Schedule)
 
 		set_lowTime();
 
@@ -449,6 +560,10 @@ public:
 
 	void interrupt_routine()
 	{
+	#if defined(WWVB_LOW_POWER)
+		if (_is_idle) { ++asleep_ticks; }
+		else { ++awake_ticks; }
+	#endif
 		#if (F_CPU < 16000000)
 		tELAPSED = millis() - t0;
 		#endif
@@ -464,10 +579,15 @@ public:
 		_is_odd_bit = !_is_odd_bit;
 
 		// increment to the next second
-		add_time(0, 0, 1);
+		// Note: the clock is held at 23:59:59 for the leap second (23:59:60)
+		const bool _is_leap_second = (frame_index == 60) & is_leap_minute_;
+		if (!_is_leap_second)
+		{
+			add_time(0, 0, 1);
+		}
 
-		// increment the frame indices
-		if (frame_index == 60)
+		// increment the frame indices (61 bits in a leap second minute)
+		if ((frame_index >= 60) & !_is_leap_second)
 		{
 			// increment to the next minute
 			//t_ss = 0;
@@ -486,7 +606,7 @@ public:
 		//2.2. increment to the next bit in the subframe
 		//2.3. set the next WWVB_LOWTIME
 		#if (F_CPU < 16000000)
-		if (tELAPSED >= WWVB_EOB_ms)
+		if (tELAPSED >= WWVB_ENDOFBIT)
 		{
 			t0 = millis();
 		#else
@@ -511,15 +631,23 @@ public:
 
 			subframe_index = ++frame_index % 10;
 			set_lowTime();
+		#if defined(WWVB_PM)
+			set_phase();
+		#endif
 
 			// flip _is_odd_bit
 			_is_odd_bit = !_is_odd_bit;
 
 			// increment to the next second
-			add_time(0, 0, 1);
+			// Note: the clock is held at 23:59:59 for the leap second (23:59:60)
+			const bool _is_leap_second = (frame_index == 60) & is_leap_minute_;
+			if (!_is_leap_second)
+			{
+				add_time(0, 0, 1);
+			}
 
-			// increment the frame indices
-			if (frame_index == 60)
+			// increment the frame indices (61 bits in a leap second minute)
+			if ((frame_index >= 60) & !_is_leap_second)
 			{
 				// increment to the next minute
 				//t_ss = 0;
@@ -553,11 +681,37 @@ public:
 	#endif
 	}
 
-	void start()
+	// _secs : start part way through the frame, at this second (e.g. a time restored from an rtc, see wwvb_state.h)
+	// the clock seconds follow the frame index, so the minute changes at the end of the frame
+	void start(const uint8_t _secs = 0)
 	{
-		frame_index = 0;
-		subframe_index = 0;
+		frame_index = _secs;
+		subframe_index = _secs % 10;
+		t_ss = _secs;
+		set_secs(_secs);
 		set_lowTime();
+#if defined(WWVB_PM)
+		set_phase();
+#endif
+
+		// the bit starts low, as it does in the interrupt routine (setup() leaves the carrier high)
+#if !defined(WWVB_MODULATION_OUT)
+	#if (F_CPU < 16000000)
+		t0 = millis();
+	#else
+		isr_count = 0;
+	#endif
+		_is_high = false;
+		digitalWrite(LED_BUILTIN, LOW);
+	#if defined(WWVB_PAM)
+		pinMode(modulation_pin, OUTPUT);
+		digitalWrite(modulation_pin, LOW);
+	#elif defined(USE_OC1A)
+		OCR1A = PWM_LOW;
+	#elif defined(USE_OC1B)
+		OCR1B = PWM_LOW;
+	#endif
+#endif
 
 		resume();
 	}
@@ -614,9 +768,98 @@ public:
 		return _is_active;
 	}
 
+	// Time (us) until the isr next changes the output, or starts the next bit (and works out the next minute)
+	// The application can do its own work (or sleep) until then without being interrupted by a wwvb edge
+	uint32_t next_action_us()
+	{
+		uint32_t _us = 0;
+		uint8_t _sreg = SREG;
+		cli();
+#if defined(WWVB_MODULATION_OUT)
+		// Timer1 is prescaled by 256 and the isr is at TOP (ICR1)
+		_us = (uint32_t)(ICR1 - TCNT1) * (256000000UL / F_CPU);
+#elif (F_CPU < 16000000)
+		uint32_t _elapsed = millis() - t0;
+		uint32_t _edge = _is_high ? WWVB_ENDOFBIT : WWVB_LOWTIME;
+		if (_edge > _elapsed) { _us = (_edge - _elapsed) * 1000UL; }
+#else
+		// one isr tick per carrier period (2*ICR1 clocks)
+		int32_t _ticks = (_is_high ? (int32_t)(WWVB_ENDOFBIT + WWVB_EOB_CAL[_is_odd_bit]) : (int32_t)WWVB_LOWTIME) - isr_count;
+		if (_ticks > 0) { _us = ((uint32_t)_ticks * 2UL * ICR1) / (F_CPU / 1000000UL); }
+#endif
+		SREG = _sreg;
+		return _us;
+	}
+
+#if defined(WWVB_LOW_POWER)
+	// Sleep (SLEEP_MODE_IDLE) until the next interrupt, e.g. call it at the end of loop()
+	// Timer1 is still clocked in idle, so the carrier and the isr are unaffected. Each isr tick is counted
+	// as asleep or awake, so asleep_ticks / (asleep_ticks + awake_ticks) is the fraction of carrier periods
+	// the application was asleep for (the isr itself still runs every carrier period)
+	void idle()
+	{
+		set_sleep_mode(SLEEP_MODE_IDLE);
+		cli();
+		_is_idle = true;
+		sleep_enable();
+		sei(); // the instruction after sei() is always executed, so the wake up interrupt cant be missed
+		sleep_cpu();
+		sleep_disable();
+		_is_idle = false;
+	}
+
+	// isr ticks (carrier periods) spent asleep and awake since the last reset_power()
+	void get_power(uint32_t &_asleep_ticks, uint32_t &_awake_ticks)
+	{
+		uint8_t _sreg = SREG;
+		cli();
+		_asleep_ticks = asleep_ticks;
+		_awake_ticks = awake_ticks;
+		SREG = _sreg;
+	}
+
+	// estimated supply current (in the units of _active and _idle) from the asleep / awake duty cycle
+	// e.g. power_estimate(9000, 2500) for the ATmega328p at 16MHz 5V (typical uA, see the datasheet)
+	uint32_t power_estimate(const uint32_t &_active, const uint32_t &_idle)
+	{
+		uint32_t _asleep, _awake;
+		get_power(_asleep, _awake);
+
+		// scale the tick counts down to 15 bits, so the asleep fraction (in 1/65536ths) is a 32 bit division
+		while ((_asleep | _awake) > 0x7FFF)
+		{
+			_asleep >>= 1;
+			_awake >>= 1;
+		}
+		const uint32_t _ticks = _asleep + _awake;
+		if (_ticks == 0) { return _active; }
+		const uint32_t _fraction = (_asleep << 16) / _ticks;
+		return scale_q16(_idle, _fraction) + scale_q16(_active, 65536UL - _fraction);
+	}
+
+	// _value * _fraction / 65536 (_fraction 0 - 65536) without overflowing 32 bits
+	static uint32_t scale_q16(const uint32_t &_value, const uint32_t &_fraction)
+	{
+		return (_value >> 16) * _fraction + (((_value & 0xFFFF) * _fraction) >> 16);
+	}
+
+	void reset_power()
+	{
+		uint8_t _sreg = SREG;
+		cli();
+		asleep_ticks = 0;
+		awake_ticks = 0;
+		SREG = _sreg;
+	}
+#endif
+
 	void debug_time()
 	{
-#if (_DEBUG > 0)
+#if defined(WWVB_TELEMETRY)
+		uint8_t _payload[WWVB_TLM_STATE_SIZE];
+		snapshot(_payload, true);
+		telemetry.record(WWVB_TLM_STATE, _payload, WWVB_TLM_STATE_SIZE);
+#elif (_DEBUG > 0)
 		Serial.println(F("internal state"));
 		print_datetime(hour_, mins_, DD_, MM_, YY_);
 
@@ -629,7 +872,7 @@ public:
 		uint16_t doty = get_doty();
 		uint8_t year = get_year();
 
-		float dut1 = get_dut1();
+		int8_t dut1 = get_dut1();
 		bool is_ly, is_ls;
 		uint8_t ds;
 		get_misc(is_ly, is_ls, ds);
@@ -640,7 +883,13 @@ public:
 		print_datetime(hour, mins, day, month, year);
 
 		Serial.print(F("dut1 = "));
-		Serial.println(dut1);
+		if (dut1 == WWVB_DUT1_ERROR) { Serial.println(F("error")); }
+		else
+		{
+			Serial.print((dut1 < 0) ? '-' : '+');
+			Serial.print(F("0."));
+			Serial.println(abs(dut1));
+		}
 		Serial.print(F("leap year = "));
 		if (is_ly) { Serial.println(F("true")); }
 		else { Serial.println(F("false")); }
@@ -672,6 +921,83 @@ public:
 		_YY = YY_;
 	}
 
+	// symbol sent at _frame_index : 0 - LOW (0.2s), 1 - HIGH (0.5s), 2 - MARKER (0.8s)
+	uint8_t symbol(const uint8_t _frame_index)
+	{
+		// Check for a frame marker
+		switch (_frame_index)
+		{
+			// markers
+		case 0:  // start frame
+		case 9:  // end MINS
+		case 19: // end HOUR
+		case 29: // end DOTY
+		case 39: // end DUT1
+		case 49: // end YEAR
+			return 2;
+		case 59: // end MISC, end frame (or a 0 before the leap second)
+			return is_leap_minute_ ? 0 : 2;
+		case 60: // leap second, or the start of the next frame (the isr wraps frame_index after set_lowTime)
+		case 61: // start of the next frame after a leap second
+			return 2;
+		}
+
+		// No frame marker, so return the subframe bit data
+		uint8_t sI = _frame_index % 10;
+		if (_frame_index < 10) // MINS
+		{
+			return MINS[sI];
+		}
+		else if (_frame_index < 20) // HOUR
+		{
+			return HOUR[sI];
+		}
+		else if (_frame_index < 30) // DOTY
+		{
+			return DOTY[sI];
+		}
+		else if (_frame_index < 40) // DUT1
+		{
+			return DUT1[sI];
+		}
+		else if (_frame_index < 50) // YEAR
+		{
+			return YEAR[sI];
+		}
+		return MISC[sI]; // MISC
+	}
+
+	// time the carrier is held low for _symbol, in isr ticks (ms if F_CPU < 16MHz)
+	uint16_t pulse_ticks(const uint8_t &_symbol)
+	{
+		return pulse_width[_symbol];
+	}
+
+	// length of a bit in isr ticks, including the end of bit calibration
+	// Note: the first bit after start() is an odd bit, then they alternate
+	uint16_t bit_ticks(const bool &_is_odd_bit)
+	{
+		return WWVB_ENDOFBIT + WWVB_EOB_CAL[_is_odd_bit] + 1;
+	}
+
+#if defined(WWVB_PM)
+	// the current phase modulation frame (see wwvb_pm.h) : bit n is 1 if the carrier is inverted at second n
+	uint64_t pm_frame()
+	{
+		return pm_frame_;
+	}
+#endif
+	// the current frame packed into a uint64_t (see wwvb_frame.h) : bit n is the data bit sent at second n
+	uint64_t frame()
+	{
+		uint64_t _frame = 0;
+		for (uint8_t i = 60; i-- > 0;)
+		{
+			_frame = (_frame << 1) | (symbol(i) == 1);
+		}
+		return _frame;
+	}
+
 	void setPWM_LOW(const uint8_t &_value)
 	{
 		// dont allow it to be set higher than the max 8 bit value
@@ -684,6 +1010,22 @@ public:
 		PWM_HIGH = min(_value, 255);
 	}
 
+	uint8_t getPWM_LOW()
+	{
+		return PWM_LOW;
+	}
+
+	uint8_t getPWM_HIGH()
+	{
+		return PWM_HIGH;
+	}
+
+	// WWVB_PAM modulation pin (see setup)
+	uint8_t getModulationPin()
+	{
+		return modulation_pin;
+	}
+
 	void setTimezone(const int8_t &_hour, const int8_t &_mins)
 	{
 		timezone_HH = _hour;
@@ -694,10 +1036,78 @@ public:
 		_hour = timezone_HH;
 		_mins = timezone_MM;
 	}
+	// Set the daylight savings rule used when the time is set with WWVB_DST_AUTO
+	// e.g. wwvb_dst_us (default), wwvb_dst_eu, wwvb_dst_none or your own (see wwvb_dst.h)
+	void setDSTRule(const wwvb_dst_rule &_rule)
+	{
+		dst_rule_ = _rule;
+		daily_doty_ = 0; // work it out again on the next set_time / add_time
+	}
+	// daylight savings code being sent : 0 - no, 1 - ends today, 2 - begins today, 3 - yes
+	uint8_t getDST()
+	{
+		return daylight_savings_;
+	}
+	// daylight savings mode of the last set_time : WWVB_DST_AUTO or the fixed code
+	uint8_t getDSTMode()
+	{
+		return dst_mode_;
+	}
+	// Set DUT1 in tenths of a second (-9 to +9), used before the first entry of the DUT1 schedule
+	// returns false (and keeps the current DUT1) if _dut1 is out of range
+	bool setDUT1(const int8_t &_dut1)
+	{
+		if (!wwvb_frame_dut1_valid(_dut1))
+		{
+			return false;
+		}
+		dut1_ = _dut1;
+		daily_doty_ = 0; // work it out again on the next set_time / add_time
+		return true;
+	}
+	// Set the DUT1 schedule : _count entries in date order, each applies from 00:00 UTC on its day
+	// returns false (and keeps the current schedule) if any entry is out of range (-9 to +9)
+	// Note: the schedule isnt copied, so it needs to stay in scope
+	bool setDUT1Schedule(const wwvb_dut1_step *_schedule, const uint8_t &_count)
+	{
+		for (uint8_t i = 0; i < _count; ++i)
+		{
+			if (!wwvb_frame_dut1_valid(_schedule[i].dut1))
+			{
+				return false;
+			}
+		}
+		dut1_schedule_ = _schedule;
+		dut1_count_ = _count;
+		daily_doty_ = 0;
+		return true;
+	}
+	// Set the leap second schedule : the leap second warning (MISC[6]) is sent from the start of the month,
+	// and the 23:59 UTC frame on the last day of the month has 61 seconds
+	// Note: the schedule isnt copied, so it needs to stay in scope
+	void setLeapSecondSchedule(const wwvb_leap_second *_schedule, const uint8_t &_count)
+	{
+		leap_schedule_ = _schedule;
+		leap_count_ = _count;
+		daily_doty_ = 0;
+	}
+	// number of bits in the frame being sent (61 in a leap second minute)
+	uint8_t frame_length()
+	{
+		return 60 + is_leap_minute_;
+	}
+	// _daylight_savings : WWVB_DST_NO (default), WWVB_DST_ENDS, WWVB_DST_BEGINS, WWVB_DST_YES - send this code
+	//                     WWVB_DST_AUTO - use the daylight savings rule (worked out once per day)
 	void set_time(const uint8_t &_hour, const uint8_t &_mins,
 		const uint8_t &_DD, const uint8_t &_MM, const uint8_t &_YY,
-		const uint8_t _daylight_savings = 0)
+		const uint8_t _daylight_savings = WWVB_DST_NO)
 	{
+		dst_mode_ = _daylight_savings;
+		daily_doty_ = 0; // force the daylight savings code, DUT1 and the leap second to be worked out
+#if defined(WWVB_PM)
+		pm_mins_ = 0xFF;
+#endif
+
 		// get the current time
 		t_mm = _mins;
 		t_hh = _hour;
@@ -708,7 +1118,7 @@ public:
 		addTimezone<volatile uint8_t>(t_hh, t_mm, t_ss, t_DD, t_MM, t_YY, timezone_HH, timezone_MM, 0);
 
 		// set the correct frame bits
-		set_time(_daylight_savings);
+		set_time();
 	}
 	void add_time(const uint8_t &_hour, const uint8_t &_mins, const uint8_t _secs = 0)
 	{
@@ -726,7 +1136,7 @@ public:
 		print_datetime(hour_, mins_, DD_, MM_, YY_);
 	}
 #if( REQUIRE_TIMEDATESTRING == 1)
-	void set_time(char dateString[], char timeString[], const uint8_t _daylight_savings = 0)
+	void set_time(char dateString[], char timeString[], const uint8_t _daylight_savings = WWVB_DST_NO)
 	{
 
 		uint8_t _hour, _mins, _secs, _DD, _MM, _YY;
@@ -740,8 +1150,11 @@ public:
 private:
 	/// set
 	// this function performs no range-checking of variables
-	void set_time(const uint8_t _daylight_savings = 0)
+	void set_time()
 	{
+#if defined(WWVB_TELEMETRY)
+		++frame_seq_;
+#endif
 		bool _is_leap_year = is_leap_year(2000 + t_YY);
 		uint16_t _doty = to_day_of_the_year<volatile uint8_t>(t_DD, t_MM, _is_leap_year);
 
@@ -755,10 +1168,55 @@ private:
 		set_month(t_MM);
 
 		set_doty(_doty);
-		set_dut1(); // only need to do this once at setup as we set dut1 to all zeros
 		set_year(t_YY);
 
-		set_misc(_is_leap_year, _daylight_savings);
+		// daylight savings, DUT1 and the leap second are only worked out when the day changes
+		const uint8_t _YY = t_YY;
+		if ((_doty != daily_doty_) | (_YY != daily_YY_))
+		{
+			daily_doty_ = _doty;
+			daily_YY_ = _YY;
+
+			set_dut1(scheduled_dut1(_YY, _doty));
+			set_leap_second(_YY, t_MM, _doty, _is_leap_year);
+
+			if (dst_mode_ != WWVB_DST_AUTO)
+			{
+				set_daylight_savings(dst_mode_);
+			}
+			else if (dst_rule_ != 0)
+			{
+				set_daylight_savings(dst_rule_(_YY, _doty));
+			}
+			else
+			{
+				set_daylight_savings(WWVB_DST_NO);
+			}
+#if defined(WWVB_PM)
+			const uint8_t _daylight_savings = daylight_savings_;
+			pm_dst_next_ = ((dst_mode_ == WWVB_DST_AUTO) & (dst_rule_ != 0))
+				? wwvb_pm_dst_next(dst_rule_(_YY, 1), dst_rule_(_YY, 182))
+				: wwvb_pm_dst_next(_daylight_savings, _daylight_savings);
+#endif
+		}
+		is_leap_minute_ = is_leap_day_ & (t_hh == 23) & (t_mm == 59);
+
+		set_misc(_is_leap_year);
+
+#if defined(WWVB_PM)
+		// the phase modulation frame is only worked out when the minute changes
+		const uint8_t _mins = mins_;
+		if (pm_mins_ != _mins)
+		{
+			const uint8_t _hour = hour_, _daylight_savings = daylight_savings_, _dst_next = pm_dst_next_;
+			const bool _leap_second_warning = MISC[6];
+			pm_mins_ = _mins;
+			pm_frame_ = wwvb_pm_encode_frame(_hour, _mins, _doty, _YY, _daylight_savings, _leap_second_warning, _dst_next);
+		}
+#endif
+#if defined(WWVB_TELEMETRY)
+		++frame_seq_;
+#endif
 	}
 	void set_secs(uint8_t _secs)
 	{
@@ -843,21 +1301,55 @@ private:
 			DUT1[3] = (_doty & 0x01);
 		}
 	}
-	void set_dut1()
+	// DUT1 for day _doty of 20_YY : the last schedule entry on or before that day
+	int8_t scheduled_dut1(const uint8_t &_YY, const uint16_t &_doty)
+	{
+		int8_t _dut1 = dut1_;
+		for (uint8_t i = 0; i < dut1_count_; ++i)
+		{
+			const wwvb_dut1_step &_step = dut1_schedule_[i];
+			if ((_step.YY > _YY) | ((_step.YY == _YY) & (_step.doty > _doty)))
+			{
+				break;
+			}
+			_dut1 = _step.dut1;
+		}
+		return _dut1;
+	}
+	void set_dut1(int8_t _dut1)
 	{
 		// DUT1             0   1   2   3   4   5   6   7   8   9
 		//                  8   4   2   1   -   -  (+) (-) (+)  M
-		DUT1[6] = 1; // set sign to +ve
-		DUT1[8] = 1; // set sign to +ve
-
+		bool _is_negative = (_dut1 < 0);
+		DUT1[6] = !_is_negative;
+		DUT1[7] = _is_negative;
+		DUT1[8] = !_is_negative;
+
+		// the DUT1 value (resides in YEAR)
+		// YEAR             0   1   2   3   4   5   6   7   8   9
+		//                 0.8 0.4 0.2 0.1  -  80  40  20  10   M
+		// clamp before negating (-128 cant be negated as an int8_t)
+		if (_dut1 < -WWVB_DUT1_MAX) { _dut1 = -WWVB_DUT1_MAX; }
+		if (_dut1 > WWVB_DUT1_MAX) { _dut1 = WWVB_DUT1_MAX; }
+		if (_is_negative) { _dut1 = -_dut1; }
+		YEAR[0] = (_dut1 >> 3) & 0x01;
+		YEAR[1] = (_dut1 >> 2) & 0x01;
+		YEAR[2] = (_dut1 >> 1) & 0x01;
+		YEAR[3] = _dut1 & 0x01;
+	}
+	void set_leap_second(const uint8_t &_YY, const uint8_t _MM, const uint16_t &_doty, const bool &_is_leap_year)
+	{
+		// the leap second warning is sent from the start of the month up to the leap second
+		bool _is_warning = false;
+		for (uint8_t i = 0; i < leap_count_; ++i)
+		{
+			_is_warning |= (leap_schedule_[i].YY == _YY) & (leap_schedule_[i].MM == _MM);
+		}
+		MISC[6] = _is_warning;
 
-		// clear the first 4 values
-		YEAR[0] = 0;
-		YEAR[1] = 0;
-		YEAR[2] = 0;
-		YEAR[3] = 0;
-		// Note: +ve, -ve makes not difference because the DUT1 value
-		// (resides in YEAR) is set to zero on the next line
+		// the leap second is at the end of the last day of the month
+		uint16_t _last = (_MM == 12) ? 365 + _is_leap_year : to_day_of_the_year<uint8_t>(1, _MM + 1, _is_leap_year) - 1;
+		is_leap_day_ = _is_warning & (_doty == _last);
 	}
 	void set_day(uint8_t _DD)
 	{
@@ -901,9 +1393,9 @@ private:
 			MISC[3] = (_year & 0x01);
 		}
 	}
-	void set_misc(const bool &_is_leap_year, const uint8_t &_daylight_savings)
+	void set_misc(const bool &_is_leap_year)
 	{
-		// set leap year, leap second and daylight saving time info
+		// set leap year info (the leap second warning is set by set_leap_second)
 		//                  0   1   2   3   4   5   6   7   8   9
 		//                  8   4   2   1   - LYI LSW   2   1   M
 		if (is_leap_year_ != _is_leap_year)
@@ -912,7 +1404,12 @@ private:
 
 			MISC[5] = _is_leap_year;
 		}
-		MISC[6] = 0; // Ignore leap second
+	}
+	void set_daylight_savings(const uint8_t &_daylight_savings)
+	{
+		// set daylight saving time info
+		//                  0   1   2   3   4   5   6   7   8   9
+		//                  8   4   2   1   - LYI LSW   2   1   M
 		if (daylight_savings_ != _daylight_savings)
 		{
 			daylight_savings_ = _daylight_savings;
@@ -956,7 +1453,8 @@ private:
 
 		return _temp;
 	}
-	float get_dut1()
+	// DUT1 in tenths of a second, or WWVB_DUT1_ERROR
+	int8_t get_dut1()
 	{
 		// DUT1
 		// 0   1   2   3   4   5   6   7   8   9
@@ -964,7 +1462,7 @@ private:
 		// YEAR
 		//  0   1   2   3   4   5   6   7   8   9
 		// 0.8 0.4 0.2 0.1  -  80  40  20  10   M
-		float _temp = YEAR[0] * 0.8f + YEAR[1] * 0.4f + YEAR[2] * 0.2f + YEAR[3] * 0.1f;
+		int8_t _temp = YEAR[0] * 8 + YEAR[1] * 4 + YEAR[2] * 2 + YEAR[3] * 1;
 
 		if (DUT1[7])
 		{
@@ -972,7 +1470,7 @@ private:
 		}
 		else if (!(DUT1[6] & DUT1[8]))
 		{
-			_temp = -999; // ERROR
+			_temp = WWVB_DUT1_ERROR;
 		}
 
 		return _temp;
@@ -1000,49 +1498,27 @@ private:
 		_is_leap_second = MISC[6];
 		_daylight_savings = ((MISC[7] << 1) & 0x2) | (MISC[8] & 0x01);
 	}
+#if defined(WWVB_PM)
+	// Invert the carrier (a 180 degree phase shift) for a phase modulation 1
+	// Note: this is called from the Timer1 overflow isr (at BOTTOM), so the compare output mode changes
+	//       at a carrier cycle boundary. Inverting the output changes the duty cycle d to 1 - d, which
+	//       has the same fundamental amplitude (sin(pi * d)), so the amplitude modulation is unchanged
+	void set_phase()
+	{
+		const bool _is_inverted = (frame_index < 60) && ((pm_frame_ >> frame_index) & 0x01);
+#if defined(USE_OC1A)
+		if (_is_inverted) { TCCR1A |= _BV(COM1A0); }
+		else { TCCR1A &= ~_BV(COM1A0); }
+#elif defined(USE_OC1B)
+		if (_is_inverted) { TCCR1A |= _BV(COM1B0); }
+		else { TCCR1A &= ~_BV(COM1B0); }
+#endif
+	}
+#endif
 	void set_lowTime()
 	{
-		// Check for a frame marker
-		switch (frame_index)
-		{
-			// markers
-		case 0:  // start frame
-		case 9:  // end MINS
-		case 19: // end HOUR
-		case 29: // end DOTY
-		case 39: // end DUT1
-		case 49: // end YEAR
-		case 59: // end MISC, end frame
-			WWVB_LOWTIME = WWVB_MARKER;
-			return;
-		}
-
-		// No frame marker, so set the subframe bit data
 		subframe_index = frame_index % 10;
-		if (frame_index < 10) // MINS
-		{
-			WWVB_LOWTIME = pulse_width[MINS[subframe_index]];
-		}
-		else if (frame_index < 20) // HOUR
-		{
-			WWVB_LOWTIME = pulse_width[HOUR[subframe_index]];
-		}
-		else if (frame_index < 30) // DOTY
-		{
-			WWVB_LOWTIME = pulse_width[DOTY[subframe_index]];
-		}
-		else if (frame_index < 40) // DUT1
-		{
-			WWVB_LOWTIME = pulse_width[DUT1[subframe_index]];
-		}
-		else if (frame_index < 50) // YEAR
-		{
-			WWVB_LOWTIME = pulse_width[YEAR[subframe_index]];
-		}
-		else if (frame_index < 60) // MISC
-		{
-			WWVB_LOWTIME = pulse_width[MISC[subframe_index]];
-		}
+		WWVB_LOWTIME = pulse_width[symbol(frame_index)];
 	}
 };
 
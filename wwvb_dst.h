@@ -0,0 +1,108 @@
+#ifndef wwvb_dst_h
+#define wwvb_dst_h
+
+/*
+Daylight savings rules
+
+A rule returns the 2 bit wwvb daylight savings code (MISC[7:8]) for a day of the year.
+The code is worked out once per day by the wwvb class, so sending a frame never evaluates the rule.
+
+MISC[7] : daylight savings is in effect at 24:00 (the end of the day)
+MISC[8] : daylight savings is in effect at 00:00 (the start of the day)
+
+code | MISC[7:8] |
+-----+-----------+------------------
+ 0   |    00     | not in effect
+ 1   |    01     | ends today
+ 2   |    10     | begins today
+ 3   |    11     | in effect
+
+Provided rules
+* wwvb_dst_us   : US (default) - 2nd Sunday in March to the 1st Sunday in November
+* wwvb_dst_eu   : EU           - last Sunday in March to the last Sunday in October
+* wwvb_dst_none : never in effect
+
+A rule is any function with the signature of wwvb_dst_rule, see wwvb::setDSTRule
+Note: the rule is evaluated on the date being sent (i.e. after the wwvb timezone is applied)
+
+This has no Arduino dependencies so it can be used on the host.
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <stdint.h>
+
+#define WWVB_DST_NO 0
+#define WWVB_DST_ENDS 1
+#define WWVB_DST_BEGINS 2
+#define WWVB_DST_YES 3
+#define WWVB_DST_AUTO 0xFF // use the daylight savings rule
+
+// returns the daylight savings code for day _doty of 20_YY
+typedef uint8_t (*wwvb_dst_rule)(const uint8_t &_YY, const uint16_t &_doty);
+
+// day of the week for day _doty of 20_YY : 0 - Sunday ... 6 - Saturday
+inline uint8_t wwvb_day_of_week(const uint8_t &_YY, const uint16_t &_doty)
+{
+	// 1 Jan 2000 was a Saturday, each year moves it on by 1 day (365 % 7), plus 1 for each leap year
+	return (6 + _YY + (_YY + 3) / 4 + _doty - 1) % 7;
+}
+
+// day of the year of the _n'th _dow (0 - Sunday) of month _MM (1 - 12) in 20_YY
+// _n = 5 is the last _dow of the month
+inline uint16_t wwvb_nth_day_of_week(const uint8_t &_YY, const uint8_t &_MM, const uint8_t &_n, const uint8_t &_dow)
+{
+	static const uint16_t month_start[13] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365 };
+	const uint8_t _leap = ((_YY & 0x03) == 0);
+
+	uint16_t _first = month_start[_MM - 1] + 1 + ((_MM > 2) & _leap);
+	uint16_t _doty = _first + (7 + _dow - wwvb_day_of_week(_YY, _first)) % 7 + 7 * (_n - 1);
+
+	uint16_t _next_month = month_start[_MM] + 1 + ((_MM > 1) & _leap);
+	while (_doty >= _next_month)
+	{
+		_doty -= 7;
+	}
+	return _doty;
+}
+
+// daylight savings code for _doty when daylight savings begins on day _begin and ends on day _end
+// (southern hemisphere rules have _begin > _end)
+inline uint8_t wwvb_dst_code(const uint16_t &_doty, const uint16_t &_begin, const uint16_t &_end)
+{
+	bool _at_start, _at_end;
+	if (_begin <= _end)
+	{
+		_at_start = (_doty > _begin) & (_doty <= _end);
+		_at_end = (_doty >= _begin) & (_doty < _end);
+	}
+	else
+	{
+		_at_start = !((_doty > _end) & (_doty <= _begin));
+		_at_end = !((_doty >= _end) & (_doty < _begin));
+	}
+	return (_at_end << 1) | _at_start;
+}
+
+inline uint8_t wwvb_dst_us(const uint8_t &_YY, const uint16_t &_doty)
+{
+	return wwvb_dst_code(_doty, wwvb_nth_day_of_week(_YY, 3, 2, 0), wwvb_nth_day_of_week(_YY, 11, 1, 0));
+}
+
+inline uint8_t wwvb_dst_eu(const uint8_t &_YY, const uint16_t &_doty)
+{
+	return wwvb_dst_code(_doty, wwvb_nth_day_of_week(_YY, 3, 5, 0), wwvb_nth_day_of_week(_YY, 10, 5, 0));
+}
+
+inline uint8_t wwvb_dst_none(const uint8_t &_YY, const uint16_t &_doty)
+{
+	(void)_YY;
+	(void)_doty;
+	return WWVB_DST_NO;
+}
+
+#endif
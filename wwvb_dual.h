@@ -0,0 +1,217 @@
+#ifndef wwvb_dual_h
+#define wwvb_dual_h
+
+/*
+Dual channel wwvb : two independent time codes on OC1A (D9) and OC1B (D10)
+
+One Timer1 carrier (phase & frequency correct PWM, see wwvb::setup) drives both compare outputs.
+Each channel counts its own isr ticks, so the second channel costs a count and a compare per isr tick,
+and its own frame bit and time keeping once per second.
+
+Each channel is a wwvb (channel[0] : OC1A, channel[1] : OC1B) that is only used for its frame and bit timing,
+so each has its own timezone, daylight savings rule / code, DUT1, leap second schedule and calibrate(), e.g.
+
+wwvb_dual wwvb_tx;
+ISR(TIMER1_OVF_vect) { wwvb_tx.interrupt_routine(); }
+
+wwvb_tx.channel[0].setTimezone(6, 0);  // CST clock
+wwvb_tx.channel[1].setTimezone(8, 0);  // PST clock
+wwvb_tx.setup();
+wwvb_tx.set_time(__DATE__, __TIME__);  // sets both channels
+wwvb_tx.start();
+
+Note: this only supports PWM output (no WWVB_PAM, WWVB_MODULATION_OUT or WWVB_PM) with a 16MHz ATmega328p or ATmega32u4
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <Arduino.h>
+
+#if defined(WWVB_PAM) | defined(WWVB_MODULATION_OUT) | defined(WWVB_PM)
+#pragma message("ERROR : wwvb_dual only supports PWM output")
+#endif
+
+#if (F_CPU != 16000000)
+#pragma message("ERROR : wwvb_dual only supports 16MHz ATmega328p and ATmega32u4 boards")
+#endif
+
+#include <wwvb.h>
+
+class wwvb_dual
+{
+private:
+	uint8_t PWM_LOW, PWM_HIGH;
+
+	volatile bool _is_active = false;
+
+	// per channel : isr ticks into the current bit, ticks in the bit (see wwvb::bit_ticks),
+	// low time of the bit, and if the carrier has gone high
+	volatile uint16_t isr_count[2] = { 0, 0 };
+	volatile uint16_t bit_end[2] = { 0, 0 };
+	volatile bool _is_odd_bit[2] = { true, true };
+	volatile uint16_t WWVB_LOWTIME[2];
+	volatile bool _is_high[2] = { false, false };
+
+	void set_level(const uint8_t &_channel, const bool &_high)
+	{
+		_is_high[_channel] = _high;
+		if (_channel == 0)
+		{
+			OCR1A = _high ? PWM_HIGH : PWM_LOW;
+		}
+		else
+		{
+			OCR1B = _high ? PWM_HIGH : PWM_LOW;
+		}
+	}
+
+	// one isr tick of _channel (see wwvb::interrupt_routine), the debug LED follows channel 0
+	void tick(const uint8_t &_channel)
+	{
+		const uint16_t _count = ++isr_count[_channel];
+		if (_count >= bit_end[_channel])
+		{
+			isr_count[_channel] = 0;
+			const bool _is_odd = !_is_odd_bit[_channel];
+			_is_odd_bit[_channel] = _is_odd;
+			bit_end[_channel] = channel[_channel].bit_ticks(_is_odd);
+			if (_channel == 0) { digitalWrite(LED_BUILTIN, LOW); }
+
+			next_bit(_channel);
+			return;
+		}
+		if ((_is_high[_channel] == false) & (_count >= WWVB_LOWTIME[_channel]))
+		{
+			if (_channel == 0) { digitalWrite(LED_BUILTIN, HIGH); }
+			set_level(_channel, true);
+		}
+	}
+
+	// start the next bit of _channel (see wwvb::interrupt_routine)
+	void next_bit(const uint8_t &_channel)
+	{
+		wwvb &_ch = channel[_channel];
+
+		set_level(_channel, false);
+		const uint8_t _frame_index = ++frame_index[_channel];
+		WWVB_LOWTIME[_channel] = _ch.pulse_ticks(_ch.symbol(_frame_index));
+
+		// increment to the next second
+		// Note: the clock is held at 23:59:59 for the leap second (23:59:60)
+		const bool _is_leap_second = (_frame_index == 60) & (_ch.frame_length() == 61);
+		if (!_is_leap_second)
+		{
+			_ch.add_time(0, 0, 1);
+		}
+		if ((_frame_index >= 60) & !_is_leap_second)
+		{
+			frame_index[_channel] = 0;
+		}
+	}
+
+public:
+	wwvb channel[2];
+	volatile uint8_t frame_index[2] = { 0, 0 };
+
+	wwvb_dual()
+	{
+		pinMode(9, OUTPUT);  // OC1A
+		pinMode(10, OUTPUT); // OC1B
+	}
+
+	void setup()
+	{
+		for (uint8_t c = 0; c < 2; ++c)
+		{
+			channel[c].set(12030, 30075, 48120, 60150);
+		}
+
+		// Use Phase & Frequency correct PWM (see wwvb::setup)
+		TCCR1B = _BV(WGM13); // Mode 8: Phase & Frequency correct PWM
+		ICR1 = 133; // Set PWM to 60kHz (16MHz / (2*133)) = 60150Hz
+		PWM_HIGH = 66; // ~50% duty cycle
+		PWM_LOW = 6; // ~5% duty cycle
+
+		// Clear OC1A and OC1B on compare match
+		TCCR1A = _BV(COM1A1) | _BV(COM1B1);
+		OCR1A = PWM_HIGH;
+		OCR1B = PWM_HIGH;
+
+		// enable interrupt on Timer1 overflow
+		TIMSK1 |= _BV(TOIE1);
+
+		sei(); // enable interrupts
+	}
+
+	void setPWM_LOW(const uint8_t &_value)
+	{
+		PWM_LOW = (_value < 133) ? _value : 133;
+	}
+
+	void setPWM_HIGH(const uint8_t &_value)
+	{
+		PWM_HIGH = (_value < 133) ? _value : 133;
+	}
+
+	// set both channels, each applies its own timezone and daylight savings
+	void set_time(const uint8_t &_hour, const uint8_t &_mins,
+		const uint8_t &_DD, const uint8_t &_MM, const uint8_t &_YY,
+		const uint8_t _daylight_savings = WWVB_DST_NO)
+	{
+		channel[0].set_time(_hour, _mins, _DD, _MM, _YY, _daylight_savings);
+		channel[1].set_time(_hour, _mins, _DD, _MM, _YY, _daylight_savings);
+	}
+#if( REQUIRE_TIMEDATESTRING == 1)
+	void set_time(char dateString[], char timeString[], const uint8_t _daylight_savings = WWVB_DST_NO)
+	{
+		channel[0].set_time(dateString, timeString, _daylight_savings);
+		channel[1].set_time(dateString, timeString, _daylight_savings);
+	}
+#endif
+
+	void start()
+	{
+		for (uint8_t c = 0; c < 2; ++c)
+		{
+			isr_count[c] = 0;
+			_is_odd_bit[c] = true;
+			bit_end[c] = channel[c].bit_ticks(true);
+			frame_index[c] = 0;
+			WWVB_LOWTIME[c] = channel[c].pulse_ticks(channel[c].symbol(0));
+			set_level(c, false);
+		}
+		resume();
+	}
+	void stop()
+	{
+		_is_active = false;
+
+		// Set clock prescalar to 000 (STOP Timer/Clock)
+		TCCR1B &= ~_BV(CS12) & ~_BV(CS11) & ~_BV(CS10);
+	}
+	void resume()
+	{
+		_is_active = true;
+
+		// Set clock prescalar to 1
+		TCCR1B |= _BV(CS10);
+	}
+	bool is_active()
+	{
+		return _is_active;
+	}
+
+	void interrupt_routine()
+	{
+		//This routine is checked at each counter overflow - i.e. at 60kHz
+		//each channel has its own bit timing (calibrate), on the shared carrier
+		tick(0);
+		tick(1);
+	}
+};
+
+#endif
@@ -0,0 +1,369 @@
+#ifndef wwvb_frame_h
+#define wwvb_frame_h
+
+/*
+Packed wwvb frames
+
+A frame is packed into a uint64_t, bit n is the data bit sent at second n (1 = HIGH, 0 = LOW).
+The markers (0,9,19,29,39,49,59) carry no data and are always 0, see WWVB_FRAME_MARKERS.
+
+This has no Arduino dependencies so the same encoder can be used on the host,
+e.g. to generate frames for a range of dates and compare them to wwvb::frame()
+
+        0   1   2   3   4   5   6   7   8   9
+MINS    M  40  20  10   0   8   4   2   1   M
+HOUR    -   -  20  10   0   8   4   2   1   M
+DOTY    -   - 200 100   0  80  40  20  10   M
+DUT1    8   4   2   1   -   -   +   -   +   M
+YEAR  0.8 0.4 0.2 0.1   -  80  40  20  10   M
+MISC    8   4   2   1   - LYI LSW   2   1   M
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <stdint.h>
+
+// bits 0,9,19,29,39,49,59
+#define WWVB_FRAME_MARKERS 0x0802008020080201ULL
+
+// DUT1 sign bits
+#define WWVB_FRAME_DUT1_POSITIVE ((1ULL << 36) | (1ULL << 38))
+#define WWVB_FRAME_DUT1_NEGATIVE (1ULL << 37)
+
+// BCD digits are sent MSB first, so the bits are reversed when packed
+// e.g. 8 4 2 1 -> bit 0 = 8, bit 3 = 1
+const uint8_t wwvb_frame_rev4[16] = { 0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF };
+
+// years are 2000 - 2099 (00 - 99)
+inline bool wwvb_frame_is_leap_year(const uint8_t &_YY)
+{
+	return (_YY & 0x03) == 0;
+}
+
+// symbol sent at _index : 0 - LOW (0.2s), 1 - HIGH (0.5s), 2 - MARKER (0.8s)
+inline uint8_t wwvb_frame_symbol(const uint64_t &_frame, const uint8_t &_index)
+{
+	if ((WWVB_FRAME_MARKERS >> _index) & 0x01)
+	{
+		return 2;
+	}
+	return (_frame >> _index) & 0x01;
+}
+
+// MINS field
+inline uint64_t wwvb_frame_mins(const uint8_t &_mins)
+{
+	return ((uint64_t)(wwvb_frame_rev4[_mins / 10] >> 1) << 1)
+		| ((uint64_t)wwvb_frame_rev4[_mins % 10] << 5);
+}
+
+// HOUR field
+inline uint64_t wwvb_frame_hour(const uint8_t &_hour)
+{
+	return ((uint64_t)(wwvb_frame_rev4[_hour / 10] >> 2) << 12)
+		| ((uint64_t)wwvb_frame_rev4[_hour % 10] << 15);
+}
+
+// DOTY field (the units are sent in the first 4 bits of DUT1)
+inline uint64_t wwvb_frame_doty(const uint16_t &_doty)
+{
+	return ((uint64_t)(wwvb_frame_rev4[_doty / 100] >> 2) << 22)
+		| ((uint64_t)wwvb_frame_rev4[(_doty / 10) % 10] << 25)
+		| ((uint64_t)wwvb_frame_rev4[_doty % 10] << 30);
+}
+
+// YEAR field (the units are sent in the first 4 bits of MISC)
+inline uint64_t wwvb_frame_year(const uint8_t &_YY)
+{
+	return ((uint64_t)wwvb_frame_rev4[_YY / 10] << 45)
+		| ((uint64_t)wwvb_frame_rev4[_YY % 10] << 50);
+}
+
+// DUT1 is sent as 0.0 - 0.9s and a sign, in tenths of a second
+#define WWVB_DUT1_MAX 9
+
+inline bool wwvb_frame_dut1_valid(const int8_t &_dut1)
+{
+	return (_dut1 >= -WWVB_DUT1_MAX) & (_dut1 <= WWVB_DUT1_MAX);
+}
+
+// DUT1 sign and value (in the first 4 bits of YEAR), _dut1 is in tenths of a second (-9 to +9)
+// Note: _dut1 is clamped to -9 to +9 (-128 cant be negated, and > 9 isnt a BCD digit)
+inline uint64_t wwvb_frame_dut1(const int8_t &_dut1)
+{
+	if (_dut1 < 0)
+	{
+		return WWVB_FRAME_DUT1_NEGATIVE | ((uint64_t)wwvb_frame_rev4[(_dut1 < -WWVB_DUT1_MAX) ? WWVB_DUT1_MAX : -_dut1] << 40);
+	}
+	return WWVB_FRAME_DUT1_POSITIVE | ((uint64_t)wwvb_frame_rev4[(_dut1 > WWVB_DUT1_MAX) ? WWVB_DUT1_MAX : _dut1] << 40);
+}
+
+// MISC field : leap year indicator and daylight savings
+// _daylight_savings : 00 - no, 10 - starts today, 11 - yes, 01 - ends today
+inline uint64_t wwvb_frame_misc(const bool &_is_leap_year, const uint8_t &_daylight_savings)
+{
+	return ((uint64_t)_is_leap_year << 55)
+		| ((uint64_t)((_daylight_savings >> 1) & 0x01) << 57)
+		| ((uint64_t)(_daylight_savings & 0x01) << 58);
+}
+
+// Encode a single frame
+// this function performs no range-checking of variables
+// Note: bit 59 of a leap second minute (61 bits) is a 0 rather than a marker, see wwvb::symbol
+inline uint64_t wwvb_encode_frame(const uint8_t &_hour, const uint8_t &_mins,
+	const uint16_t &_doty, const uint8_t &_YY, const uint8_t &_daylight_savings = 0,
+	const int8_t &_dut1 = 0, const bool &_leap_second_warning = false)
+{
+	return wwvb_frame_mins(_mins) | wwvb_frame_hour(_hour) | wwvb_frame_doty(_doty)
+		| wwvb_frame_dut1(_dut1) | wwvb_frame_year(_YY)
+		| wwvb_frame_misc(wwvb_frame_is_leap_year(_YY), _daylight_savings)
+		| ((uint64_t)_leap_second_warning << 56);
+}
+
+// Step the calendar on by one minute, the year wraps from 99 to 00
+// returns what rolled over : 0 - minute, 1 - hour, 2 - day (or year)
+inline uint8_t wwvb_next_minute(uint8_t &_hour, uint8_t &_mins, uint16_t &_doty, uint8_t &_YY)
+{
+	if (++_mins < 60)
+	{
+		return 0;
+	}
+	_mins = 0;
+	if (++_hour < 24)
+	{
+		return 1;
+	}
+	_hour = 0;
+	if (++_doty > 365 + wwvb_frame_is_leap_year(_YY))
+	{
+		_doty = 1;
+		_YY = (_YY == 99) ? 0 : _YY + 1;
+	}
+	return 2;
+}
+
+// Encode _count consecutive minute frames starting at _hour:_mins on day _doty of 20_YY
+// Only the fields that change are re-encoded, so this is cheap enough to generate years of frames
+// The daylight savings code, DUT1 and the leap second warning are the same for every frame
+inline void wwvb_encode_frames(uint8_t _hour, uint8_t _mins, uint16_t _doty, uint8_t _YY,
+	uint64_t *_frames, uint32_t _count, const uint8_t _daylight_savings = 0,
+	const int8_t _dut1 = 0, const bool _leap_second_warning = false)
+{
+	const uint64_t _fixed = wwvb_frame_dut1(_dut1) | ((uint64_t)_leap_second_warning << 56);
+	uint64_t _day = wwvb_frame_doty(_doty) | _fixed | wwvb_frame_year(_YY)
+		| wwvb_frame_misc(wwvb_frame_is_leap_year(_YY), _daylight_savings);
+	uint64_t _hours = wwvb_frame_hour(_hour) | _day;
+
+	for (uint32_t i = 0; i < _count; ++i)
+	{
+		_frames[i] = wwvb_frame_mins(_mins) | _hours;
+
+		switch (wwvb_next_minute(_hour, _mins, _doty, _YY))
+		{
+		case 2:
+			_day = wwvb_frame_doty(_doty) | _fixed | wwvb_frame_year(_YY)
+				| wwvb_frame_misc(wwvb_frame_is_leap_year(_YY), _daylight_savings);
+			// fall through
+		case 1:
+			_hours = wwvb_frame_hour(_hour) | _day;
+		}
+	}
+}
+
+// Encode _count frames from arrays of fields (no calendar walk, each frame is independent)
+// The fields are passed as separate arrays so that wwvb_encode_bulk can encode 4 (SSE2) or
+// 8 (AVX2) frames at a time on the host, the AVR (and anything else) uses this scalar encoder
+// _dut1 is in tenths of a second (-9 to +9, clamped), _leap_second_warning is 0 or 1
+// this function performs no range-checking of the other variables
+inline void wwvb_encode_bulk_scalar(const uint8_t *_hour, const uint8_t *_mins, const uint16_t *_doty,
+	const uint8_t *_YY, const uint8_t *_daylight_savings, const int8_t *_dut1, const uint8_t *_leap_second_warning,
+	uint64_t *_frames, const uint32_t &_count)
+{
+	for (uint32_t i = 0; i < _count; ++i)
+	{
+		_frames[i] = wwvb_encode_frame(_hour[i], _mins[i], _doty[i], _YY[i], _daylight_savings[i],
+			_dut1[i], _leap_second_warning[i]);
+	}
+}
+
+#if !defined(__AVR__) & (defined(__SSE2__) | defined(__AVX2__))
+#include <string.h>
+#include <immintrin.h>
+
+/*
+The SIMD encoder works on 32 bit lanes, one frame per lane, as two halves of the frame
+lo : bits  0 - 31 (MINS, HOUR, DOTY, the first 2 bits of the DOTY units)
+hi : bits 32 - 59 (the last 2 bits of the DOTY units, DUT1, YEAR, MISC)
+
+DUT1 is loaded as an unsigned byte (two's complement), so the sign is bit 7 and |DUT1| = ((x ^ m) + sign) & 0xFF, m = 0xFF * sign,
+clamped to 9 like wwvb_frame_dut1
+
+Division by a constant is done with shifts and adds (valid for 0 - 366)
+v / 10  = (v * 205) >> 11, 205 = 128 + 64 + 8 + 4 + 1
+v / 100 = (v *  41) >> 12,  41 =  32 +  8 + 1
+*/
+#if defined(__AVX2__)
+struct wwvb_simd
+{
+	typedef __m256i v;
+	static const uint8_t lanes = 8;
+
+	static v load8(const uint8_t *_p) { return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)_p)); }
+	static v load16(const uint16_t *_p) { return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)_p)); }
+	static v set(const uint32_t &_x) { return _mm256_set1_epi32(_x); }
+	static v add(const v &_a, const v &_b) { return _mm256_add_epi32(_a, _b); }
+	static v sub(const v &_a, const v &_b) { return _mm256_sub_epi32(_a, _b); }
+	static v and_(const v &_a, const v &_b) { return _mm256_and_si256(_a, _b); }
+	static v or_(const v &_a, const v &_b) { return _mm256_or_si256(_a, _b); }
+	static v xor_(const v &_a, const v &_b) { return _mm256_xor_si256(_a, _b); }
+	static v min_(const v &_a, const v &_b) { return _mm256_min_epi32(_a, _b); }
+	template <int N> static v sll(const v &_a) { return _mm256_slli_epi32(_a, N); }
+	template <int N> static v srl(const v &_a) { return _mm256_srli_epi32(_a, N); }
+	static void store(uint64_t *_p, const v &_lo, const v &_hi)
+	{
+		// unpack gives frames [0 1 | 4 5] and [2 3 | 6 7]
+		v _a = _mm256_unpacklo_epi32(_lo, _hi);
+		v _b = _mm256_unpackhi_epi32(_lo, _hi);
+		_mm256_storeu_si256((__m256i *)_p, _mm256_permute2x128_si256(_a, _b, 0x20));
+		_mm256_storeu_si256((__m256i *)(_p + 4), _mm256_permute2x128_si256(_a, _b, 0x31));
+	}
+};
+#else
+struct wwvb_simd
+{
+	typedef __m128i v;
+	static const uint8_t lanes = 4;
+
+	static v load8(const uint8_t *_p)
+	{
+		int32_t _x;
+		memcpy(&_x, _p, 4);
+		__m128i _zero = _mm_setzero_si128();
+		return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(_x), _zero), _zero);
+	}
+	static v load16(const uint16_t *_p) { return _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)_p), _mm_setzero_si128()); }
+	static v set(const uint32_t &_x) { return _mm_set1_epi32(_x); }
+	static v add(const v &_a, const v &_b) { return _mm_add_epi32(_a, _b); }
+	static v sub(const v &_a, const v &_b) { return _mm_sub_epi32(_a, _b); }
+	static v and_(const v &_a, const v &_b) { return _mm_and_si128(_a, _b); }
+	static v or_(const v &_a, const v &_b) { return _mm_or_si128(_a, _b); }
+	static v xor_(const v &_a, const v &_b) { return _mm_xor_si128(_a, _b); }
+	static v min_(const v &_a, const v &_b)
+	{
+		// no _mm_min_epi32 in SSE2
+		__m128i _a_greater = _mm_cmpgt_epi32(_a, _b);
+		return _mm_or_si128(_mm_and_si128(_a_greater, _b), _mm_andnot_si128(_a_greater, _a));
+	}
+	template <int N> static v sll(const v &_a) { return _mm_slli_epi32(_a, N); }
+	template <int N> static v srl(const v &_a) { return _mm_srli_epi32(_a, N); }
+	static void store(uint64_t *_p, const v &_lo, const v &_hi)
+	{
+		_mm_storeu_si128((__m128i *)_p, _mm_unpacklo_epi32(_lo, _hi));
+		_mm_storeu_si128((__m128i *)(_p + 2), _mm_unpackhi_epi32(_lo, _hi));
+	}
+};
+#endif
+
+// v / 10
+inline wwvb_simd::v wwvb_simd_div10(const wwvb_simd::v &_x)
+{
+	typedef wwvb_simd S;
+	wwvb_simd::v _y = S::add(S::add(S::sll<7>(_x), S::sll<6>(_x)), S::add(S::add(S::sll<3>(_x), S::sll<2>(_x)), _x));
+	return S::srl<11>(_y);
+}
+
+// v / 100
+inline wwvb_simd::v wwvb_simd_div100(const wwvb_simd::v &_x)
+{
+	typedef wwvb_simd S;
+	return S::srl<12>(S::add(S::add(S::sll<5>(_x), S::sll<3>(_x)), _x));
+}
+
+// v - 10 * q
+inline wwvb_simd::v wwvb_simd_mod10(const wwvb_simd::v &_x, const wwvb_simd::v &_q)
+{
+	typedef wwvb_simd S;
+	return S::sub(_x, S::add(S::sll<3>(_q), S::sll<1>(_q)));
+}
+
+// reverse the bits of a nibble, see wwvb_frame_rev4
+inline wwvb_simd::v wwvb_simd_rev4(const wwvb_simd::v &_x)
+{
+	typedef wwvb_simd S;
+	const wwvb_simd::v _1 = S::set(1), _2 = S::set(2);
+	return S::or_(S::or_(S::sll<3>(S::and_(_x, _1)), S::sll<1>(S::and_(_x, _2))),
+		S::or_(S::and_(S::srl<1>(_x), _2), S::and_(S::srl<3>(_x), _1)));
+}
+
+inline void wwvb_encode_bulk(const uint8_t *_hour, const uint8_t *_mins, const uint16_t *_doty,
+	const uint8_t *_YY, const uint8_t *_daylight_savings, const int8_t *_dut1, const uint8_t *_leap_second_warning,
+	uint64_t *_frames, const uint32_t &_count)
+{
+	typedef wwvb_simd S;
+	const S::v _1 = S::set(1), _3 = S::set(3), _0xFF = S::set(0xFF);
+
+	uint32_t i = 0;
+	for (; i + S::lanes <= _count; i += S::lanes)
+	{
+		S::v _mm = S::load8(_mins + i);
+		S::v _hh = S::load8(_hour + i);
+		S::v _dd = S::load16(_doty + i);
+		S::v _yy = S::load8(_YY + i);
+		S::v _ds = S::load8(_daylight_savings + i);
+		S::v _du = S::load8((const uint8_t *)_dut1 + i);
+		S::v _ls = S::load8(_leap_second_warning + i);
+
+		S::v _mm_tens = wwvb_simd_div10(_mm);
+		S::v _hh_tens = wwvb_simd_div10(_hh);
+		S::v _dd_tens = wwvb_simd_div10(_dd);
+		S::v _dd_hundreds = wwvb_simd_div100(_dd);
+		S::v _yy_tens = wwvb_simd_div10(_yy);
+
+		S::v _dd_units = wwvb_simd_rev4(wwvb_simd_mod10(_dd, _dd_tens));
+
+		// MINS, HOUR, DOTY
+		S::v _lo = S::or_(S::sll<1>(S::srl<1>(wwvb_simd_rev4(_mm_tens))),
+			S::sll<5>(wwvb_simd_rev4(wwvb_simd_mod10(_mm, _mm_tens))));
+		_lo = S::or_(_lo, S::or_(S::sll<12>(S::srl<2>(wwvb_simd_rev4(_hh_tens))),
+			S::sll<15>(wwvb_simd_rev4(wwvb_simd_mod10(_hh, _hh_tens)))));
+		_lo = S::or_(_lo, S::or_(S::sll<22>(S::srl<2>(wwvb_simd_rev4(_dd_hundreds))),
+			S::sll<25>(wwvb_simd_rev4(wwvb_simd_mod10(_dd_tens, _dd_hundreds)))));
+		_lo = S::or_(_lo, S::sll<30>(S::and_(_dd_units, _3)));
+
+		// DUT1 sign (+ : 36 38, - : 37) and value
+		S::v _du_negative = S::srl<7>(_du);
+		S::v _du_value = S::and_(S::add(S::xor_(_du, S::sub(S::sll<8>(_du_negative), _du_negative)), _du_negative), _0xFF);
+		_du_value = S::min_(_du_value, S::set(WWVB_DUT1_MAX));
+		S::v _du_positive = S::xor_(_du_negative, _1);
+		S::v _du_bits = S::or_(S::or_(S::sll<4>(_du_positive), S::sll<6>(_du_positive)), S::sll<5>(_du_negative));
+		_du_bits = S::or_(_du_bits, S::sll<8>(wwvb_simd_rev4(_du_value)));
+
+		// DOTY, DUT1, YEAR, MISC
+		S::v _hi = S::or_(S::srl<2>(_dd_units), _du_bits);
+		_hi = S::or_(_hi, S::or_(S::sll<13>(wwvb_simd_rev4(_yy_tens)),
+			S::sll<18>(wwvb_simd_rev4(wwvb_simd_mod10(_yy, _yy_tens)))));
+		S::v _not_leap_year = S::and_(S::add(S::and_(_yy, _3), _3), S::set(4)); // 0 if _yy & 3 == 0, else 4
+		_hi = S::or_(_hi, S::sll<21>(S::sub(S::set(4), _not_leap_year)));
+		_hi = S::or_(_hi, S::sll<24>(S::and_(_ls, _1)));
+		_hi = S::or_(_hi, S::or_(S::sll<24>(S::and_(_ds, S::set(2))), S::sll<26>(S::and_(_ds, _1))));
+
+		S::store(_frames + i, _lo, _hi);
+	}
+
+	wwvb_encode_bulk_scalar(_hour + i, _mins + i, _doty + i, _YY + i, _daylight_savings + i, _dut1 + i, _leap_second_warning + i,
+		_frames + i, _count - i);
+}
+#else
+inline void wwvb_encode_bulk(const uint8_t *_hour, const uint8_t *_mins, const uint16_t *_doty,
+	const uint8_t *_YY, const uint8_t *_daylight_savings, const int8_t *_dut1, const uint8_t *_leap_second_warning,
+	uint64_t *_frames, const uint32_t &_count)
+{
+	wwvb_encode_bulk_scalar(_hour, _mins, _doty, _YY, _daylight_savings, _dut1, _leap_second_warning, _frames, _count);
+}
+#endif
+
+#endif
@@ -0,0 +1,308 @@
+#ifndef wwvb_montecarlo_h
+#define wwvb_montecarlo_h
+
+/*
+Monte Carlo drift and jitter simulation (host only)
+
+Runs thousands of independent simulated transmitters over a grid of calibrate(), ICR1 and
+PWM_LOW values, with a random crystal error and isr latency per transmitter, and reports
+the distribution of frame period error and how often a receiver model (wwvb_receiver.h) locks.
+
+The transmitter model follows interrupt_routine() tick for tick
+* a bit is bit_ticks = WWVB_ENDOFBIT + calibrate + 1 carrier periods, low for pulse_ticks
+* a carrier period is 2 * ICR1 / (F_CPU * (1 + crystal error))
+* if the isr is held off for longer than a carrier period (Serial, millis, SoftwareSerial)
+  the Timer1 overflow is lost and the bit is one tick longer, this is modelled as a
+  per-tick probability of losing the tick
+* isr latency delays each edge by 0 - latency_cycles cpu cycles
+
+The host build can run the same trials with the real interrupt_routine() as the transmitter
+(extras/host/wwvb_montecarlo_isr.h), to check the model against it.
+
+Trials are seeded from (grid point, trial) so results dont depend on the number of threads.
+The trials of a grid point are run in chunks of WWVB_MC_CHUNK, each summed on its own and merged in order,
+so the floating point sums are the same (bit for bit) however the chunks are shared between threads.
+Work is split into ranges of chunks, one per thread; a thread that runs out of work steals
+half of the remaining range of another thread (wwvb_mc_parallel, also used by wwvb_montecarlo_isr.h).
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <stdint.h>
+#include <math.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <wwvb_frame.h>
+#include <wwvb_receiver.h>
+
+// frame period error histogram : WWVB_MC_BINS bins of WWVB_MC_BIN_us, centered on 0
+#define WWVB_MC_BINS 64
+#define WWVB_MC_BIN_us 500
+
+// trials per work item
+#define WWVB_MC_CHUNK 16
+
+// a point in the parameter grid
+struct wwvb_mc_point
+{
+	int16_t calibrate;
+	uint16_t icr1;
+	uint8_t pwm_low;
+};
+
+struct wwvb_mc_config
+{
+	uint32_t f_cpu;                 // e.g. 16000000
+	uint16_t pulse_ticks[3];        // LOW, HIGH, MARKER e.g. 12030, 30075, 48120
+	uint16_t endofbit;              // e.g. 60150
+	uint8_t pwm_high;               // PWM_HIGH e.g. 66
+	float crystal_ppm;              // crystal error is uniform in +/- crystal_ppm
+	float lost_tick_ppm;            // probability (per million) of losing a Timer1 overflow
+	uint16_t latency_cycles;        // isr latency is uniform in 0 - latency_cycles
+	uint8_t frames;                 // frames per trial
+	wwvb_receiver_model model;
+};
+
+struct wwvb_mc_result
+{
+	uint32_t trials;
+	uint32_t frames;
+	uint32_t locked;
+	uint64_t lock_seconds;          // sum over the trials that locked
+	double frame_error_us;          // sum of the frame period error
+	double frame_error2_us;         // sum of the squared frame period error
+	double frame_error_max_us;      // largest absolute frame period error
+	uint32_t histogram[WWVB_MC_BINS];
+
+	void clear()
+	{
+		trials = 0; frames = 0; locked = 0; lock_seconds = 0;
+		frame_error_us = 0; frame_error2_us = 0; frame_error_max_us = 0;
+		for (uint8_t i = 0; i < WWVB_MC_BINS; ++i) { histogram[i] = 0; }
+	}
+
+	void merge(const wwvb_mc_result &_r)
+	{
+		trials += _r.trials; frames += _r.frames; locked += _r.locked; lock_seconds += _r.lock_seconds;
+		frame_error_us += _r.frame_error_us; frame_error2_us += _r.frame_error2_us;
+		if (_r.frame_error_max_us > frame_error_max_us) { frame_error_max_us = _r.frame_error_max_us; }
+		for (uint8_t i = 0; i < WWVB_MC_BINS; ++i) { histogram[i] += _r.histogram[i]; }
+	}
+
+	// fraction of the transmitters that a receiver locked onto
+	double acceptance() { return trials ? (double)locked / trials : 0; }
+	double mean_lock_s() { return locked ? (double)lock_seconds / locked : 0; }
+	// frame period error statistics (per frame)
+	double mean_us() { return frames ? frame_error_us / frames : 0; }
+	double rms_us() { return frames ? sqrt(frame_error2_us / frames) : 0; }
+};
+
+// xorshift64* - small, fast, and seedable per trial
+class wwvb_mc_random
+{
+private:
+	uint64_t state;
+
+public:
+	wwvb_mc_random(const uint64_t &_seed) : state(_seed * 0x9E3779B97F4A7C15ULL + 1) {}
+
+	uint64_t next()
+	{
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		return state * 0x2545F4914F6CDD1DULL;
+	}
+
+	// uniform in [0, 1)
+	double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+	// poisson with a small mean (lost ticks per bit)
+	uint32_t poisson(const double &_mean)
+	{
+		double _l = exp(-_mean), _p = uniform();
+		uint32_t _k = 0;
+		for (double _s = _l; (_p > _s) & (_k < 1000); _s += _l)
+		{
+			_l *= _mean / ++_k;
+		}
+		return _k;
+	}
+};
+
+// One simulated transmitter feeding one receiver
+inline void wwvb_mc_trial(const wwvb_mc_config &_cfg, const wwvb_mc_point &_point,
+	const uint64_t &_seed, wwvb_mc_result &_result)
+{
+	wwvb_mc_random _rng(_seed);
+
+	const double _f_cpu = _cfg.f_cpu * (1.0 + (2.0 * _rng.uniform() - 1.0) * _cfg.crystal_ppm * 1e-6);
+	const double _tick_us = 2.0 * _point.icr1 * 1e6 / _f_cpu;
+	const double _cycle_us = 1e6 / _f_cpu;
+	const uint32_t _bit_ticks = _cfg.endofbit + _point.calibrate + 1;
+
+	wwvb_receiver _rx(_cfg.model);
+	_rx.carrier((uint32_t)(_f_cpu / (2.0 * _point.icr1) + 0.5),
+		wwvb_receiver::depth_dB(_point.pwm_low, _cfg.pwm_high, _point.icr1));
+
+	// random start time, so the frames arent all the same
+	uint8_t _hour = _rng.next() % 24, _mins = _rng.next() % 60, _YY = _rng.next() % 100;
+	uint16_t _doty = 1 + _rng.next() % 365;
+
+	double _latency_us = _rng.uniform() * _cfg.latency_cycles * _cycle_us;
+	for (uint8_t f = 0; f < _cfg.frames; ++f)
+	{
+		uint64_t _frame = wwvb_encode_frame(_hour, _mins, _doty, _YY);
+		double _frame_us = 0;
+		for (uint8_t i = 0; i < 60; ++i)
+		{
+			// ticks lost while low lengthen the low time, ticks lost at any time lengthen the bit
+			uint32_t _low_ticks = _cfg.pulse_ticks[wwvb_frame_symbol(_frame, i)];
+			uint32_t _lost_low = _rng.poisson(_low_ticks * _cfg.lost_tick_ppm * 1e-6);
+			uint32_t _lost = _lost_low + _rng.poisson((_bit_ticks - _low_ticks) * _cfg.lost_tick_ppm * 1e-6);
+
+			// the edges move by the change in isr latency
+			double _rise_latency_us = _rng.uniform() * _cfg.latency_cycles * _cycle_us;
+			double _next_latency_us = _rng.uniform() * _cfg.latency_cycles * _cycle_us;
+
+			double _low_us = (_low_ticks + _lost_low) * _tick_us + _rise_latency_us - _latency_us;
+			double _period_us = (_bit_ticks + _lost) * _tick_us + _next_latency_us - _latency_us;
+			_latency_us = _next_latency_us;
+			_frame_us += _period_us;
+
+			_rx.pulse((uint32_t)_low_us, (uint32_t)_period_us);
+		}
+		wwvb_next_minute(_hour, _mins, _doty, _YY);
+
+		double _error_us = _frame_us - 60e6;
+		++_result.frames;
+		_result.frame_error_us += _error_us;
+		_result.frame_error2_us += _error_us * _error_us;
+		if (fabs(_error_us) > _result.frame_error_max_us) { _result.frame_error_max_us = fabs(_error_us); }
+		int32_t _bin = (int32_t)floor(_error_us / WWVB_MC_BIN_us) + WWVB_MC_BINS / 2;
+		_bin = (_bin < 0) ? 0 : ((_bin >= WWVB_MC_BINS) ? WWVB_MC_BINS - 1 : _bin);
+		++_result.histogram[_bin];
+	}
+
+	++_result.trials;
+	if (_rx.locked())
+	{
+		++_result.locked;
+		_result.lock_seconds += _rx.time_to_lock();
+	}
+}
+
+// Run _trials trials for every one of _points grid points on _threads threads (0 = all cores)
+// _trial(point, seed, result) runs one trial, seed = point * _trials + trial
+// _results must have room for _points results
+template <typename Trial>
+inline void wwvb_mc_parallel(const uint32_t &_points, const uint32_t &_trials, wwvb_mc_result *_results,
+	uint32_t _threads, const Trial &_trial)
+{
+	if (_threads == 0)
+	{
+		_threads = std::thread::hardware_concurrency();
+		_threads = (_threads == 0) ? 1 : _threads;
+	}
+
+	// work item n = chunk n % _chunks of point n / _chunks
+	// each thread owns a range [begin, end) packed into 64 bits
+	const uint32_t _chunks = (_trials + WWVB_MC_CHUNK - 1) / WWVB_MC_CHUNK;
+	const uint32_t _items = _points * _chunks;
+	std::vector<std::atomic<uint64_t> > _ranges(_threads);
+	for (uint32_t t = 0; t < _threads; ++t)
+	{
+		uint64_t _begin = (uint64_t)_items * t / _threads, _end = (uint64_t)_items * (t + 1) / _threads;
+		_ranges[t] = (_begin << 32) | _end;
+	}
+
+	// per chunk results, merged in order at the end
+	std::vector<wwvb_mc_result> _partial(_items);
+	for (size_t i = 0; i < _partial.size(); ++i) { _partial[i].clear(); }
+
+	auto _worker = [&](const uint32_t _t)
+	{
+		for (;;)
+		{
+			// take a chunk from the front of our own range
+			uint64_t _r = _ranges[_t].load();
+			uint32_t _begin = _r >> 32, _end = (uint32_t)_r;
+			if (_begin < _end)
+			{
+				if (!_ranges[_t].compare_exchange_weak(_r, ((uint64_t)(_begin + 1) << 32) | _end))
+				{
+					continue;
+				}
+				const uint32_t _point = _begin / _chunks, _first = (_begin % _chunks) * WWVB_MC_CHUNK;
+				const uint32_t _last = (_first + WWVB_MC_CHUNK < _trials) ? _first + WWVB_MC_CHUNK : _trials;
+				for (uint32_t n = _first; n < _last; ++n)
+				{
+					_trial(_point, (uint64_t)_point * _trials + n, _partial[_begin]);
+				}
+				continue;
+			}
+
+			// out of work - steal the back half of the largest remaining range
+			uint32_t _victim = _t, _most = 0;
+			for (uint32_t v = 0; v < _threads; ++v)
+			{
+				uint64_t _vr = _ranges[v].load();
+				uint32_t _left = (uint32_t)_vr - (uint32_t)(_vr >> 32);
+				if (((uint32_t)(_vr >> 32) < (uint32_t)_vr) & (_left > _most)) { _most = _left; _victim = v; }
+			}
+			if (_most == 0)
+			{
+				return;
+			}
+			uint64_t _vr = _ranges[_victim].load();
+			uint32_t _vbegin = _vr >> 32, _vend = (uint32_t)_vr;
+			if (_vbegin >= _vend)
+			{
+				continue;
+			}
+			uint32_t _split = _vbegin + (_vend - _vbegin + 1) / 2;
+			if (_ranges[_victim].compare_exchange_strong(_vr, ((uint64_t)_vbegin << 32) | _split))
+			{
+				_ranges[_t] = ((uint64_t)_split << 32) | _vend;
+			}
+		}
+	};
+
+	std::vector<std::thread> _pool;
+	for (uint32_t t = 0; t < _threads; ++t)
+	{
+		_pool.push_back(std::thread(_worker, t));
+	}
+	for (uint32_t t = 0; t < _threads; ++t)
+	{
+		_pool[t].join();
+	}
+
+	for (uint32_t p = 0; p < _points; ++p)
+	{
+		_results[p].clear();
+		for (uint32_t c = 0; c < _chunks; ++c)
+		{
+			_results[p].merge(_partial[(size_t)p * _chunks + c]);
+		}
+	}
+}
+
+// Run _trials transmitters for every point of the grid on _threads threads (0 = all cores)
+// _results must have room for _points results
+inline void wwvb_montecarlo(const wwvb_mc_config &_cfg, const wwvb_mc_point *_grid, const uint32_t &_points,
+	const uint32_t &_trials, wwvb_mc_result *_results, uint32_t _threads = 0)
+{
+	wwvb_mc_parallel(_points, _trials, _results, _threads,
+		[&](const uint32_t &_point, const uint64_t &_seed, wwvb_mc_result &_result)
+		{
+			wwvb_mc_trial(_cfg, _grid[_point], _seed, _result);
+		});
+}
+
+#endif
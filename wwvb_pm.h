@@ -0,0 +1,334 @@
+#ifndef wwvb_pm_h
+#define wwvb_pm_h
+
+/*
+WWVB phase modulation (BPSK) frames
+
+Since 2012 WWVB also sends a phase modulated time code: a 1 is sent with the carrier phase
+inverted (180 degrees) for the whole second, a 0 with the normal phase. The phase changes at the
+start of each second, at the same time as the (unchanged) amplitude modulated drop in power.
+
+A frame is packed into a uint64_t like wwvb_frame.h (bit n is the phase bit sent at second n),
+in the NIST enhanced WWVB format (fields are sent MSB first)
+
+second  | field
+--------+-----------------------------------------------------------
+0 - 12  | sync_T  0011101101000 (0x768)
+13 - 17 | time_par[4:0] : Hamming (31,26) parity of time (the NIST parity rows, see wwvb_pm_time_parity)
+18      | time[25]
+19      | time[0]
+20 - 28 | time[24:16]
+29      | 0 (reserved)
+30 - 38 | time[15:7]
+39      | 1 (reserved)
+40 - 46 | time[6:0]
+47 - 51 | dst_ls[4:0] : daylight savings code and leap second warning (NIST code table, wwvb_pm_dst_ls)
+52 - 57 | dst_next[5:0] : the daylight savings schedule (NIST code table, see wwvb_pm_dst_next)
+58 - 59 | 0
+
+time is the minute of the century (minutes since 00:00 1 Jan 2000).
+
+Note: only the 1 minute frames are sent, not the 6 minute extended frames (sync_M), and dst_next is only
+      sent as "no daylight savings", "daylight savings all year" or the catch-all code for any other
+      schedule (the codes for the exact US / EU / ... schedules are not sent).
+
+The demodulator works on complex baseband (see wwvb_render::render_iq with center_Hz within
++/-20Hz of the carrier): it squares blocks of samples to remove the modulation, estimates the residual
+carrier offset and phase, integrates each second and resolves the 180 degree ambiguity with sync_T.
+
+This has no Arduino dependencies so it can be used on the host (the demodulator is host only).
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <stdint.h>
+
+// sync_T, bit 0 is sent at second 0
+#define WWVB_PM_SYNC_T 0x2DC // 0011101101000 -> seconds 2, 3, 4, 6, 7, 9
+#define WWVB_PM_SYNC_BITS 13
+
+// dst_next (seconds 52 - 57)
+#define WWVB_PM_DST_NEXT_NEVER 0x07  // 000111 : no daylight savings
+#define WWVB_PM_DST_NEXT_ALWAYS 0x2F // 101111 : daylight savings all year
+#define WWVB_PM_DST_NEXT_OTHER 0x23  // 100011 : any other schedule
+
+// seconds of the 26 time bits, time[25] first (time[0] is also sent at second 19)
+const uint8_t wwvb_pm_time_second[26] = {
+	18, 20, 21, 22, 23, 24, 25, 26, 27, 28, 30, 31, 32, 33, 34, 35, 36, 37, 38, 40, 41, 42, 43, 44, 45, 46 };
+
+// dst_ls[4:0] for each daylight savings code (see wwvb_dst.h) | leap second warning << 2
+const uint8_t wwvb_pm_dst_ls[8] = { 0x08, 0x15, 0x16, 0x03, 0x0F, 0x10, 0x19, 0x04 };
+
+// minutes since 00:00 1 Jan 2000
+inline uint32_t wwvb_pm_minute_of_century(const uint8_t &_hour, const uint8_t &_mins, const uint16_t &_doty, const uint8_t &_YY)
+{
+	uint32_t _days = 365UL * _YY + (_YY + 3) / 4 + _doty - 1;
+	return (_days * 24 + _hour) * 60 + _mins;
+}
+
+inline void wwvb_pm_from_minute_of_century(uint32_t _minute, uint8_t &_hour, uint8_t &_mins, uint16_t &_doty, uint8_t &_YY)
+{
+	_mins = _minute % 60;
+	_minute /= 60;
+	_hour = _minute % 24;
+	uint32_t _days = _minute / 24;
+
+	_YY = 0;
+	for (;;)
+	{
+		uint16_t _year_days = ((_YY & 0x03) == 0) ? 366 : 365;
+		if (_days < _year_days)
+		{
+			break;
+		}
+		_days -= _year_days;
+		++_YY;
+	}
+	_doty = _days + 1;
+}
+
+// Hamming (31,26) parity of the 26 bit time : time_par[i] is the even parity of the time bits in row i
+//
+// time_par | time bits
+// ---------+-----------------------------------------------------------------
+//    0     | 23 21 20 17 16 15 14 13  9  8  6  5  4  2  0
+//    1     | 24 22 21 18 17 16 15 14 10  9  7  6  5  3  1
+//    2     | 25 23 22 19 18 17 16 15 11 10  8  7  6  4  2
+//    3     | 24 21 19 18 15 14 13 12 11  7  6  4  3  2  0
+//    4     | 25 22 20 19 16 15 14 13 12  8  7  5  4  3  1
+inline uint8_t wwvb_pm_time_parity(const uint32_t &_time)
+{
+	static const uint32_t _rows[5] = { 0x0B3E375, 0x167C6EA, 0x2CF8DD4, 0x12CF8DD, 0x259F1BA };
+	uint8_t _parity = 0;
+	for (uint8_t i = 0; i < 5; ++i)
+	{
+		uint32_t _x = _time & _rows[i];
+		_x ^= _x >> 16;
+		_x ^= _x >> 8;
+		_x ^= _x >> 4;
+		_x ^= _x >> 2;
+		_x ^= _x >> 1;
+		_parity |= (_x & 0x01) << i;
+	}
+	return _parity;
+}
+
+// dst_next for a daylight savings rule, from its code on 1 Jan and 1 Jul (or a fixed code for both)
+inline uint8_t wwvb_pm_dst_next(const uint8_t &_january, const uint8_t &_july)
+{
+	if ((_january == 0) & (_july == 0))
+	{
+		return WWVB_PM_DST_NEXT_NEVER;
+	}
+	if ((_january == 3) & (_july == 3))
+	{
+		return WWVB_PM_DST_NEXT_ALWAYS;
+	}
+	return WWVB_PM_DST_NEXT_OTHER;
+}
+
+// Encode a phase modulation frame
+// _daylight_savings : 00 - no, 10 - starts today, 11 - yes, 01 - ends today (see wwvb_dst.h)
+inline uint64_t wwvb_pm_encode_frame(const uint8_t &_hour, const uint8_t &_mins,
+	const uint16_t &_doty, const uint8_t &_YY, const uint8_t &_daylight_savings = 0,
+	const bool &_leap_second_warning = false, const uint8_t &_dst_next = WWVB_PM_DST_NEXT_OTHER)
+{
+	uint64_t _frame = WWVB_PM_SYNC_T;
+
+	const uint32_t _time = wwvb_pm_minute_of_century(_hour, _mins, _doty, _YY);
+	const uint8_t _parity = wwvb_pm_time_parity(_time);
+	for (uint8_t i = 0; i < 5; ++i)
+	{
+		_frame |= (uint64_t)((_parity >> (4 - i)) & 0x01) << (13 + i);
+	}
+	for (uint8_t i = 0; i < 26; ++i)
+	{
+		_frame |= (uint64_t)((_time >> (25 - i)) & 0x01) << wwvb_pm_time_second[i];
+	}
+	_frame |= (uint64_t)(_time & 0x01) << 19;
+	_frame |= 1ULL << 39;
+
+	const uint8_t _dst_ls = wwvb_pm_dst_ls[(_daylight_savings & 0x03) | (_leap_second_warning << 2)];
+	for (uint8_t i = 0; i < 5; ++i)
+	{
+		_frame |= (uint64_t)((_dst_ls >> (4 - i)) & 0x01) << (47 + i);
+	}
+	for (uint8_t i = 0; i < 6; ++i)
+	{
+		_frame |= (uint64_t)((_dst_next >> (5 - i)) & 0x01) << (52 + i);
+	}
+	return _frame;
+}
+
+// Decode a phase modulation frame, returns false if sync_T, time_par or dst_ls doesnt match
+inline bool wwvb_pm_decode_frame(const uint64_t &_frame, uint8_t &_hour, uint8_t &_mins,
+	uint16_t &_doty, uint8_t &_YY, uint8_t &_daylight_savings, bool &_leap_second_warning)
+{
+	if ((_frame & ((1UL << WWVB_PM_SYNC_BITS) - 1)) != WWVB_PM_SYNC_T)
+	{
+		return false;
+	}
+	uint32_t _time = 0;
+	for (uint8_t i = 0; i < 26; ++i)
+	{
+		_time = (_time << 1) | ((_frame >> wwvb_pm_time_second[i]) & 0x01);
+	}
+	uint8_t _parity = 0;
+	for (uint8_t i = 0; i < 5; ++i)
+	{
+		_parity = (_parity << 1) | ((_frame >> (13 + i)) & 0x01);
+	}
+	if ((_parity != wwvb_pm_time_parity(_time)) | (((_frame >> 19) & 0x01) != (_time & 0x01)))
+	{
+		return false;
+	}
+	uint8_t _dst_ls = 0;
+	for (uint8_t i = 0; i < 5; ++i)
+	{
+		_dst_ls = (_dst_ls << 1) | ((_frame >> (47 + i)) & 0x01);
+	}
+	uint8_t _code = 0;
+	while ((_code < 8) && (wwvb_pm_dst_ls[_code] != _dst_ls))
+	{
+		++_code;
+	}
+	if (_code == 8)
+	{
+		return false;
+	}
+	_daylight_savings = _code & 0x03;
+	_leap_second_warning = _code >> 2;
+
+	wwvb_pm_from_minute_of_century(_time, _hour, _mins, _doty, _YY);
+	return true;
+}
+
+#if !defined(__AVR__)
+#include <math.h>
+#include <complex>
+#include <vector>
+
+// BPSK demodulator for complex baseband (interleaved I,Q int16_t, e.g. from wwvb_render::render_iq)
+// The samples must start at the start of a second, one frame is decoded per 60 seconds of samples
+class wwvb_pm_demod
+{
+private:
+	typedef std::complex<double> cplx;
+
+	double samples_per_second;
+	double samples_per_block;
+	uint32_t block_samples;  // samples in the current block
+	double sample_count;     // samples since the start of the frame
+	cplx block;
+	std::vector<cplx> blocks;
+	std::vector<uint32_t> block_second;
+
+public:
+	// _samples_per_second : sample_rate * bit_ticks / carrier frequency (the length of a bit in samples)
+	wwvb_pm_demod(const double &_samples_per_second, const uint32_t &_blocks_per_second = 100)
+		: samples_per_second(_samples_per_second), samples_per_block(_samples_per_second / _blocks_per_second),
+		block_samples(0), sample_count(0), block(0, 0)
+	{
+	}
+
+	void reset()
+	{
+		block_samples = 0;
+		sample_count = 0;
+		block = cplx(0, 0);
+		blocks.clear();
+		block_second.clear();
+	}
+
+	// add _n complex samples, returns true when a frame (60 seconds) has been collected
+	bool samples(const int16_t *_iq, const uint32_t &_n)
+	{
+		bool _frame = false;
+		for (uint32_t k = 0; k < _n; ++k)
+		{
+			block += cplx(_iq[2 * k], _iq[2 * k + 1]);
+			++block_samples;
+			sample_count += 1;
+			// dont let a block straddle a second
+			uint32_t _second = (uint32_t)((sample_count - 1) / samples_per_second);
+			uint32_t _next_second = (uint32_t)(sample_count / samples_per_second);
+			if ((block_samples >= samples_per_block) | (_next_second != _second))
+			{
+				blocks.push_back(block);
+				block_second.push_back(_second);
+				block = cplx(0, 0);
+				block_samples = 0;
+				_frame |= (_next_second == 60);
+			}
+		}
+		return _frame;
+	}
+
+	// Demodulate the collected frame into phase bits (bit n = 1 : inverted at second n)
+	// returns false if sync_T isnt found (in either polarity)
+	bool frame(uint64_t &_frame)
+	{
+		// the squared signal has no modulation : residual carrier offset (radians per block)
+		cplx _rotation(0, 0);
+		for (size_t k = 1; k < blocks.size(); ++k)
+		{
+			_rotation += (blocks[k] * blocks[k]) * std::conj(blocks[k - 1] * blocks[k - 1]);
+		}
+		const double _w = std::arg(_rotation) / 2;
+
+		// carrier phase (to within 180 degrees)
+		cplx _phase(0, 0);
+		for (size_t k = 0; k < blocks.size(); ++k)
+		{
+			cplx _b = blocks[k] * std::polar(1.0, -_w * k);
+			_phase += _b * _b;
+		}
+		const double _theta = std::arg(_phase) / 2;
+
+		double _soft[60] = { 0 };
+		for (size_t k = 0; k < blocks.size(); ++k)
+		{
+			if (block_second[k] < 60)
+			{
+				_soft[block_second[k]] += std::real(blocks[k] * std::polar(1.0, -_w * k - _theta));
+			}
+		}
+
+		_frame = 0;
+		for (uint8_t s = 0; s < 60; ++s)
+		{
+			_frame |= (uint64_t)(_soft[s] < 0) << s;
+		}
+
+		// resolve the 180 degree ambiguity with sync_T
+		const uint64_t _sync_mask = (1ULL << WWVB_PM_SYNC_BITS) - 1;
+		if ((_frame & _sync_mask) == (~(uint64_t)WWVB_PM_SYNC_T & _sync_mask))
+		{
+			_frame = ~_frame & ((1ULL << 60) - 1);
+		}
+
+		// keep any samples past the end of the frame for the next frame
+		std::vector<cplx> _blocks;
+		std::vector<uint32_t> _block_second;
+		for (size_t k = 0; k < blocks.size(); ++k)
+		{
+			if (block_second[k] >= 60)
+			{
+				_blocks.push_back(blocks[k]);
+				_block_second.push_back(block_second[k] - 60);
+			}
+		}
+		blocks.swap(_blocks);
+		block_second.swap(_block_second);
+		sample_count -= 60 * samples_per_second;
+
+		return (_frame & _sync_mask) == WWVB_PM_SYNC_T;
+	}
+};
+#endif
+
+#endif
@@ -0,0 +1,323 @@
+#ifndef wwvb_receiver_h
+#define wwvb_receiver_h
+
+/*
+Consumer receiver emulation models
+
+Some clocks lock onto the wwvb signal and some dont (see the Casio note in README.md).
+A wwvb_receiver is fed the transmitted signal one bit (1 second) at a time
+and decides, like a consumer clock would, whether it would accept the signal and how long it
+would take to lock. Use it to sweep setPWM_LOW(), calibrate() and the carrier frequency (ICR1)
+offline instead of re-flashing and waiting on a real clock.
+
+What a receiver model checks
+* carrier : the carrier must be within carrier_tolerance_Hz of 60kHz (receivers use a narrow
+            crystal filter) and the low/high carrier level must differ by at least min_depth_dB
+* pulse   : the low time of each bit must be within pulse_tolerance_ms of 0.2s, 0.5s or 0.8s
+* period  : each bit must be within period_tolerance_ms of 1.0s
+* markers : a frame starts after two consecutive markers (59, 0), or three with a leap second (59, 60, 0),
+            and (if check_markers) the markers at 9,19,29,39,49,59 must be where they should be
+* content : the decoded BCD fields must be in range and (if check_sequence) consecutive frames
+            must be one minute apart (00:00 on the 1st of January only after 23:59 on the last day of the year)
+* lock    : the clock sets itself after frames_to_lock consecutive good frames
+
+The presets are representative models, not measurements of a particular clock.
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <stdint.h>
+
+// Symbols returned by wwvb_receiver::classify
+#define WWVB_RX_ZERO 0
+#define WWVB_RX_ONE 1
+#define WWVB_RX_MARKER 2
+#define WWVB_RX_ERROR 3
+
+struct wwvb_receiver_model
+{
+	uint16_t pulse_tolerance_ms;   // +/- window around the 0.2s, 0.5s, 0.8s low times
+	uint16_t period_tolerance_ms;  // +/- window around the 1.0s bit period
+	uint16_t carrier_tolerance_Hz; // +/- window around the 60kHz carrier
+	uint8_t min_depth_dB;          // minimum difference between the high and low carrier level
+	uint8_t frames_to_lock;        // consecutive good frames before the clock sets itself
+	bool check_markers;            // require the markers at 9,19,29,39,49,59
+	bool check_sequence;           // require consecutive frames to be one minute apart
+};
+
+//                                                    pulse period carrier depth lock markers sequence
+const wwvb_receiver_model WWVB_RX_LENIENT =         { 100,   100,    300,     6,   1, false,   false };
+const wwvb_receiver_model WWVB_RX_TYPICAL =         {  60,    50,    150,    10,   2, true,    true };
+const wwvb_receiver_model WWVB_RX_STRICT =          {  30,    20,     50,    14,   3, true,    true };
+
+class wwvb_receiver
+{
+private:
+	wwvb_receiver_model model;
+
+	uint8_t symbols[60];
+	uint8_t index;
+	bool in_frame;
+	bool last_was_marker;
+	bool can_hear;
+
+	uint8_t good_frames;
+	bool is_locked;
+	uint32_t seconds;
+	uint32_t lock_seconds;
+	uint32_t last_minute; // minute of the century of the last good frame
+
+	// decoded fields of the last good frame
+	uint8_t mins_, hour_, YY_;
+	uint16_t doty_;
+	bool is_leap_year_;
+
+	// value of the _bits bits (MSB first) starting at _start
+	// e.g. the MINS units digit : digit(5, 4) -> 8 4 2 1
+	uint8_t digit(const uint8_t &_start, const uint8_t &_bits)
+	{
+		uint8_t _value = 0;
+		for (uint8_t i = _start; i < _start + _bits; ++i)
+		{
+			_value = (_value << 1) | (symbols[i] & 0x01);
+		}
+		return _value;
+	}
+
+	bool decode()
+	{
+		// MINS             0   1   2   3   4   5   6   7   8   9
+		//                  M  40  20  10   0   8   4   2   1   M
+		// HOUR             -   -  20  10   0   8   4   2   1   M
+		// DOTY             -   - 200 100   0  80  40  20  10   M
+		// DUT1             8   4   2   1   -   -   +   -   +   M
+		// YEAR           0.8 0.4 0.2 0.1   -  80  40  20  10   M
+		// MISC             8   4   2   1   - LYI LSW   2   1   M
+		if (model.check_markers)
+		{
+			for (uint8_t i = 9; i < 60; i += 10)
+			{
+				if (symbols[i] != WWVB_RX_MARKER) { return false; }
+			}
+		}
+		for (uint8_t i = 1; i < 59; ++i)
+		{
+			if ((i % 10 != 9) & (symbols[i] == WWVB_RX_MARKER)) { return false; }
+		}
+
+		uint8_t _mins_units = digit(5, 4);
+		uint8_t _hour_units = digit(15, 4);
+		uint8_t _doty_tens = digit(25, 4);
+		uint8_t _doty_units = digit(30, 4);
+		uint8_t _year_tens = digit(45, 4);
+		uint8_t _year_units = digit(50, 4);
+		if ((_mins_units > 9) | (_hour_units > 9) | (_doty_tens > 9) | (_doty_units > 9)
+			| (_year_tens > 9) | (_year_units > 9))
+		{
+			return false;
+		}
+
+		uint8_t _mins = digit(1, 3) * 10 + _mins_units;
+		uint8_t _hour = digit(12, 2) * 10 + _hour_units;
+		uint16_t _doty = digit(22, 2) * 100 + _doty_tens * 10 + _doty_units;
+		uint8_t _year = _year_tens * 10 + _year_units;
+
+		if ((_mins > 59) | (_hour > 23) | (_doty < 1) | (_doty > 366))
+		{
+			return false;
+		}
+
+		// the minute of the century (with 366 day years) steps by one across the hour and day,
+		// only the new year needs checking on its own
+		uint32_t _minute = ((_year * 366UL + _doty) * 24UL + _hour) * 60UL + _mins;
+		if (model.check_sequence & (good_frames > 0))
+		{
+			const bool _is_new_year = (_mins == 0) & (_hour == 0) & (_doty == 1) & (_year == (YY_ + 1) % 100)
+				& (mins_ == 59) & (hour_ == 23) & (doty_ == 365 + is_leap_year_);
+			if ((_minute != last_minute + 1) & !_is_new_year)
+			{
+				good_frames = 0;
+			}
+		}
+
+		last_minute = _minute;
+		mins_ = _mins;
+		hour_ = _hour;
+		doty_ = _doty;
+		YY_ = _year;
+		is_leap_year_ = symbols[55] & 0x01;
+		return true;
+	}
+
+public:
+	wwvb_receiver(const wwvb_receiver_model &_model = WWVB_RX_TYPICAL) : model(_model)
+	{
+		reset();
+		can_hear = true;
+	}
+
+	void reset()
+	{
+		index = 0;
+		in_frame = false;
+		last_was_marker = false;
+		good_frames = 0;
+		is_locked = false;
+		seconds = 0;
+		lock_seconds = 0;
+		last_minute = 0;
+		mins_ = 0; hour_ = 0; doty_ = 0; YY_ = 0;
+		is_leap_year_ = false;
+	}
+
+	// Tune the receiver to the transmitted carrier
+	// returns false if the receiver cant hear it (then every bit is an error)
+	bool carrier(const uint32_t &_frequency_Hz, const uint8_t &_depth_dB)
+	{
+		uint32_t _error = (_frequency_Hz > 60000) ? _frequency_Hz - 60000 : 60000 - _frequency_Hz;
+		can_hear = (_error <= model.carrier_tolerance_Hz) & (_depth_dB >= model.min_depth_dB);
+		return can_hear;
+	}
+
+	// classify a single bit, from the time the carrier was low and the bit period (us)
+	uint8_t classify(const uint32_t &_low_us, const uint32_t &_period_us)
+	{
+		uint32_t _tolerance_us = model.period_tolerance_ms * 1000UL;
+		if ((_period_us + _tolerance_us < 1000000UL) | (_period_us > 1000000UL + _tolerance_us))
+		{
+			return WWVB_RX_ERROR;
+		}
+
+		_tolerance_us = model.pulse_tolerance_ms * 1000UL;
+		const uint32_t _widths[3] = { 200000UL, 500000UL, 800000UL };
+		for (uint8_t s = 0; s < 3; ++s)
+		{
+			if ((_low_us + _tolerance_us >= _widths[s]) & (_low_us <= _widths[s] + _tolerance_us))
+			{
+				return s;
+			}
+		}
+		return WWVB_RX_ERROR;
+	}
+
+	// Feed one bit of the transmitted signal into the receiver
+	// returns true if the clock is locked
+	bool pulse(const uint32_t &_low_us, const uint32_t &_period_us)
+	{
+		++seconds;
+		uint8_t _symbol = can_hear ? classify(_low_us, _period_us) : WWVB_RX_ERROR;
+
+		if (_symbol == WWVB_RX_ERROR)
+		{
+			// lost the frame - wait for the next double marker
+			in_frame = false;
+			last_was_marker = false;
+			good_frames = 0;
+			return is_locked;
+		}
+
+		if (!in_frame)
+		{
+			// a frame starts on the second of two consecutive markers (59, 0)
+			in_frame = last_was_marker & (_symbol == WWVB_RX_MARKER);
+			last_was_marker = (_symbol == WWVB_RX_MARKER);
+			index = 0;
+			if (!in_frame)
+			{
+				return is_locked;
+			}
+		}
+
+		// a leap second (60) is a third marker, the frame starts on the last of them
+		if ((index == 1) & (_symbol == WWVB_RX_MARKER))
+		{
+			index = 0;
+		}
+		symbols[index++] = _symbol;
+		last_was_marker = (_symbol == WWVB_RX_MARKER);
+
+		if (index == 60)
+		{
+			if (decode())
+			{
+				if ((++good_frames >= model.frames_to_lock) & !is_locked)
+				{
+					is_locked = true;
+					lock_seconds = seconds;
+				}
+			}
+			else
+			{
+				good_frames = 0;
+			}
+			// the next frame starts immediately after this one (marker 59 -> marker 0)
+			in_frame = last_was_marker;
+			index = 0;
+		}
+		return is_locked;
+	}
+
+	bool locked() { return is_locked; }
+	// seconds of signal before the clock locked (0 if it hasnt locked)
+	uint32_t time_to_lock() { return lock_seconds; }
+	uint8_t frames() { return good_frames; }
+
+	// decoded time of the last good frame
+	uint8_t mm() { return mins_; }
+	uint8_t hh() { return hour_; }
+	uint16_t doty() { return doty_; }
+	uint8_t YY() { return YY_; }
+
+	// Difference (dB) between the carrier level for the high and low signal
+	// when the carrier is PWM'd with duty cycles _pwm_high/_top and _pwm_low/_top
+	//
+	// The carrier level is the amplitude of the PWM fundamental ~ sin(pi*duty),
+	// approximated with Bhaskara's sin approximation to avoid floating point
+	// e.g. 16MHz : PWM_HIGH = 66, PWM_LOW = 6, ICR1 = 133 -> 16dB (-17dB in the wwvb.h notes)
+	static uint8_t depth_dB(const uint16_t &_pwm_low, const uint16_t &_pwm_high, const uint16_t &_top)
+	{
+		uint32_t _low = level(_pwm_low, _top);
+		uint32_t _high = level(_pwm_high, _top);
+		if (_low == 0)
+		{
+			return 99; // carrier off for low (PAM)
+		}
+		if (_high <= _low)
+		{
+			return 0;
+		}
+
+		// 1000 * 10^(dB/20) for dB = 1..40
+		static const uint32_t ratio_dB[40] = {
+			1122, 1259, 1413, 1585, 1778, 1995, 2239, 2512, 2818, 3162,
+			3548, 3981, 4467, 5012, 5623, 6310, 7079, 7943, 8913, 10000,
+			11220, 12589, 14125, 15849, 17783, 19953, 22387, 25119, 28184, 31623,
+			35481, 39811, 44668, 50119, 56234, 63096, 70795, 79433, 89125, 100000 };
+
+		uint32_t _ratio = (_high * 1000UL) / _low;
+		uint8_t _dB = 0;
+		while ((_dB < 40) && (_ratio >= ratio_dB[_dB]))
+		{
+			++_dB;
+		}
+		return _dB;
+	}
+
+	// Relative carrier level (0 - 1000) for a duty cycle of _pwm/_top
+	static uint32_t level(const uint16_t &_pwm, const uint16_t &_top)
+	{
+		if ((_pwm == 0) | (_pwm >= _top))
+		{
+			return 0;
+		}
+		uint32_t _x = (uint32_t)_pwm * (_top - _pwm); // x(1-x) * _top^2
+		uint32_t _t2 = (uint32_t)_top * _top;
+		return (16000UL * _x) / (5UL * _t2 - 4UL * _x);
+	}
+};
+
+#endif
@@ -0,0 +1,289 @@
+#ifndef wwvb_render_h
+#define wwvb_render_h
+
+/*
+Render the transmitted signal as a sampled waveform (host only, see extras/host)
+
+Reproduces what comes out of WWVB_OUT so it can be played back through an SDR
+or fed into a receiver model without any hardware. There is no transmitter model here : the renderer runs
+the wwvb it is given, calling wwvb::interrupt_routine() once per simulated Timer1 overflow (host_cycles, see
+extras/host/Arduino.h), and samples the output it sets up. So the frames are whatever the library sends :
+its calendar, daylight savings rule, DUT1 and leap second schedules, calibration, PWM_LOW / PWM_HIGH and any bugs.
+* the carrier is the Timer1 phase & frequency correct PWM : F_CPU / (2 * ICR1), one isr call per carrier period
+* PWM : the duty cycle is OCR1A (OCR1B with USE_OC1B) / ICR1. OCR1x is double buffered, so a value
+        written by the isr is used from the next carrier period
+* PAM : (WWVB_PAM) the carrier is scaled by pam_low (0 - 1.0) while the modulation pin is an output (low)
+* PM  : (WWVB_PM) the output is inverted (180 degree phase shift) while COM1A0 (COM1B0) is set
+* OCR = 0 (e.g. PWM_LOW = 0) holds the output low, the carrier is off
+WWVB_MODULATION_OUT (a 1Hz output, no carrier) isnt supported.
+
+Set the wwvb up as a sketch would (setup(), set_time(), setDSTRule(), setDUT1(), calibrate() ...) and start() it,
+then render from it. The renderer runs the isr itself, so dont also run host_tick().
+
+Two output formats are supported
+* render()    : the real PWM output, sampled at sample_rate (use >= 4x the carrier)
+* render_iq() : complex baseband (interleaved I,Q) of the carrier fundamental,
+                mixed down from center_Hz, sample_rate can be as low as a few kHz
+
+Rendering is streamed into caller supplied blocks (no allocation). The isr is run ahead to the next change
+of the output, and each block is split into runs of constant carrier state, so the inner per-sample loop has
+no state changes and can be vectorised by the compiler. wav_header() writes a 16 bit PCM wav header
+(1 channel for render(), 2 channels for render_iq()).
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <math.h>
+
+#if !defined(wwvb_h)
+#pragma message("ERROR : include wwvb.h before wwvb_render.h")
+#endif
+#if defined(WWVB_MODULATION_OUT)
+#pragma message("ERROR : wwvb_render.h needs the carrier output, it cant be used with WWVB_MODULATION_OUT")
+#endif
+
+struct wwvb_render_config
+{
+	uint32_t sample_rate;    // samples per second
+	float pam_low;           // carrier level for low with WWVB_PAM (0 = carrier off)
+	uint32_t center_Hz;      // render_iq() is mixed down from center_Hz
+};
+
+// output of one carrier period
+struct wwvb_render_state
+{
+	uint16_t ocr;
+	bool is_inverted; // WWVB_PM
+	bool is_low;      // WWVB_PAM : the modulation pin holds the carrier low
+
+	bool operator!=(const wwvb_render_state &_state) const
+	{
+		return (ocr != _state.ocr) | (is_inverted != _state.is_inverted) | (is_low != _state.is_low);
+	}
+};
+
+// the isr is run ahead by at most this many carrier periods (~1s) looking for the next change of the output
+#define WWVB_RENDER_MAX_RUN 65536UL
+
+class wwvb_render
+{
+private:
+	wwvb &tx;
+	wwvb_render_config cfg;
+	uint16_t icr1;
+
+	wwvb_render_state state;   // output of the current run of carrier periods
+	wwvb_render_state pending; // output of the first carrier period after it
+	uint32_t tick;             // carrier periods into the current run
+	uint32_t tick_edge;        // carrier periods in the current run
+
+	// carrier position, 32.32 fixed point carrier periods (the lower 32 bits are the carrier phase)
+	uint64_t pos;
+	uint64_t step;
+
+	// complex baseband phase (32 bit phase accumulator)
+	uint32_t iq_phase;
+	int32_t iq_step;
+
+	int16_t amplitude;
+
+	// the output as the registers are now
+	wwvb_render_state output()
+	{
+		wwvb_render_state _state;
+#if defined(USE_OC1A)
+		_state.ocr = OCR1A;
+		_state.is_inverted = TCCR1A & _BV(COM1A0);
+#elif defined(USE_OC1B)
+		_state.ocr = OCR1B;
+		_state.is_inverted = TCCR1A & _BV(COM1B0);
+#endif
+#if defined(WWVB_PAM)
+		_state.is_low = (host_pin_modes[tx.getModulationPin() & 0x1F] == OUTPUT);
+#else
+		_state.is_low = false;
+#endif
+		return _state;
+	}
+
+	// the next Timer1 overflow (BOTTOM) : OCR1x is loaded from its buffer, then the isr runs,
+	// and its changes to OCR1x are used from the overflow after this one
+	wwvb_render_state overflow()
+	{
+		host_cycles += host_timer1_period();
+		const uint16_t _ocr = output().ocr;
+		tx.interrupt_routine();
+		wwvb_render_state _state = output();
+		_state.ocr = _ocr;
+		return _state;
+	}
+
+	// duty cycle as a fraction of the carrier period (0 - 2^32)
+	uint32_t duty(const uint16_t &_ocr)
+	{
+		return (uint32_t)(((uint64_t)min(_ocr, icr1) << 32) / (2UL * icr1));
+	}
+
+	// level of the carrier fundamental (0 - 1.0) for the current carrier state
+	float level()
+	{
+		return sinf((float)M_PI * min(state.ocr, icr1) / icr1) * (state.is_low ? cfg.pam_low : 1.0f);
+	}
+
+	// run the isr to the next change of the output
+	void next_state()
+	{
+		tick -= tick_edge;
+		state = pending;
+		tick_edge = 1;
+		pending = overflow();
+		while (!(pending != state) & (tick_edge < WWVB_RENDER_MAX_RUN))
+		{
+			++tick_edge;
+			pending = overflow();
+		}
+	}
+
+	// number of samples (up to _n) before the carrier state changes
+	uint32_t run_length(const uint32_t &_n)
+	{
+		uint64_t _end = (uint64_t)(tick_edge - tick) << 32;
+		uint64_t _pos = pos & 0xFFFFFFFFULL;
+		if (_end <= _pos)
+		{
+			return 0;
+		}
+		uint64_t _samples = (_end - _pos + step - 1) / step;
+		return (_samples < _n) ? (uint32_t)_samples : _n;
+	}
+
+	void advance(const uint32_t &_samples)
+	{
+		pos += step * _samples;
+		tick += (uint32_t)(pos >> 32);
+		pos &= 0xFFFFFFFFULL;
+		while (tick >= tick_edge)
+		{
+			next_state();
+		}
+	}
+
+public:
+	// _tx : set up and started
+	wwvb_render(wwvb &_tx, const wwvb_render_config &_cfg) : tx(_tx), cfg(_cfg), icr1(ICR1)
+	{
+		// the carrier period starting now
+		pending = output();
+		tick = 0;
+		tick_edge = 0;
+		next_state();
+
+		// carrier periods per sample = F_CPU / (2 * icr1 * sample_rate)
+		pos = 0;
+		step = ((uint64_t)F_CPU << 32) / (2ULL * icr1 * cfg.sample_rate);
+
+		// (carrier - center) / sample_rate of a turn per sample
+		int64_t _offset = (((int64_t)F_CPU << 16) / (2 * icr1)) - ((int64_t)cfg.center_Hz << 16);
+		iq_phase = 0;
+		iq_step = (int32_t)((_offset << 16) / (int64_t)cfg.sample_rate);
+
+		amplitude = 32767;
+	}
+
+	void setAmplitude(const int16_t &_amplitude)
+	{
+		amplitude = _amplitude;
+	}
+
+	// carrier frequency (Hz)
+	double carrier_Hz()
+	{
+		return (double)F_CPU / (2.0 * icr1);
+	}
+
+	// Render _n samples of the real PWM output (+amplitude high, -amplitude low)
+	void render(int16_t *_samples, uint32_t _n)
+	{
+		while (_n > 0)
+		{
+			uint32_t _run = run_length(_n);
+			if (_run > 0)
+			{
+				const uint32_t _duty = duty(state.ocr);
+				const int16_t _a = state.is_low ? (int16_t)(amplitude * cfg.pam_low) : amplitude;
+				const bool _invert = state.is_inverted;
+				const uint32_t _phase = (uint32_t)pos;
+				const uint32_t _step = (uint32_t)step;
+
+				if (_duty == 0)
+				{
+					// OCR = 0 : the output is held low (0 - 0 would wrap the compare below to always high)
+					const int16_t _level = _invert ? _a : (int16_t)-_a;
+					for (uint32_t k = 0; k < _run; ++k)
+					{
+						_samples[k] = _level;
+					}
+				}
+				else
+				{
+					// output is high around the bottom of the count : 0 -> OCR ... 2*ICR1 - OCR -> 2*ICR1
+					for (uint32_t k = 0; k < _run; ++k)
+					{
+						uint32_t _p = _phase + k * _step;
+						_samples[k] = (((_p < _duty) | (_p > (uint32_t)(0 - _duty))) != _invert) ? _a : (int16_t)-_a;
+					}
+				}
+				_samples += _run;
+				_n -= _run;
+			}
+			advance(_run);
+		}
+	}
+
+	// Render _n complex samples (2*_n int16_t, interleaved I,Q) of the carrier fundamental
+	void render_iq(int16_t *_iq, uint32_t _n)
+	{
+		while (_n > 0)
+		{
+			uint32_t _run = run_length(_n);
+			if (_run > 0)
+			{
+				const float _a = amplitude * level() * (state.is_inverted ? -1.0f : 1.0f);
+				const float _turn = 2.0f * (float)M_PI / 4294967296.0f;
+				for (uint32_t k = 0; k < _run; ++k)
+				{
+					float _theta = (float)(int32_t)(iq_phase + k * (uint32_t)iq_step) * _turn;
+					_iq[2 * k] = (int16_t)(_a * cosf(_theta));
+					_iq[2 * k + 1] = (int16_t)(_a * sinf(_theta));
+				}
+				iq_phase += _run * (uint32_t)iq_step;
+				_iq += 2 * _run;
+				_n -= _run;
+			}
+			advance(_run);
+		}
+	}
+
+	// 44 byte 16 bit PCM wav header for _n samples (per channel)
+	static void wav_header(uint8_t *_header, const uint32_t &_sample_rate, const uint32_t &_n, const uint8_t &_channels)
+	{
+		const uint32_t _data = _n * _channels * 2;
+		// "RIFF" size "WAVE" "fmt " 16 [PCM channels] rate byte_rate [block_align bits] "data" size
+		const uint32_t _values[11] = { 0x46464952, 36 + _data, 0x45564157, 0x20746D66, 16,
+			(uint32_t)(1 | (_channels << 16)), _sample_rate, _sample_rate * _channels * 2,
+			(uint32_t)((_channels * 2) | (16 << 16)), 0x61746164, _data };
+		for (uint8_t i = 0; i < 11; ++i)
+		{
+			for (uint8_t b = 0; b < 4; ++b)
+			{
+				_header[4 * i + b] = (_values[i] >> (8 * b)) & 0xFF; // little endian
+			}
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,329 @@
+#ifndef wwvb_state_h
+#define wwvb_state_h
+
+/*
+Persisted wwvb state for a warm restart after a brown-out or reset
+
+A 12 byte state record is checkpointed to EEPROM (or any byte store, see wwvb_eeprom), and on boot
+the time is restored from an RTC (if there is one, see wwvb_rtc) or estimated from the last record,
+so the wwvb frames resume straight away instead of waiting for a gps fix.
+A restored time is marked WWVB_QUALITY_DEGRADED until the application calls synced().
+
+* rtc    : the minute and second are restored, start(secs()) resumes part way through the frame
+* no rtc : the time is the minute after the last checkpoint. It is late by however long the reset
+           took plus up to one checkpoint interval (the minutes since the last save), so only use it
+           to keep a receiver locked until the next re-sync
+
+byte | record
+-----+-----------------------------------------------------
+0    | seq : incremented on each write (the newest record has the highest seq, mod 256)
+1-4  | minutes since 00:00 1 Jan 2000 (UTC, as sent), little endian
+5-8  | calibrate() even, odd bit (int16_t, little endian)
+9    | daylight savings mode (WWVB_DST_AUTO or a fixed code, see set_time)
+10   | quality
+11   | crc8 (poly 0x07, init 0xFF) of bytes 0-10 (an erased or zeroed record is never valid)
+
+Wear levelling : the records are written round robin to _slots slots from _address, so each
+byte is written once every _slots checkpoints (eeprom_update_byte only writes the bytes that change).
+e.g. 32 slots (384 bytes), one checkpoint every 10 minutes : 100,000 cycles lasts ~60 years
+
+Pluggable backends (function pointers, like wwvb_dst_rule)
+* wwvb_eeprom : read / write a byte. wwvb_eeprom_avr (avr/eeprom.h) is the default on the AVR,
+                wwvb_eeprom_simulated (with write counts) is the default on the host
+* wwvb_rtc    : read / write the time in minutes and seconds. wwvb_rtc_simulated is a host rtc
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <stdint.h>
+#include <wwvb.h>
+#include <wwvb_pm.h> // minute of the century
+
+#define WWVB_QUALITY_NONE 0     // not set (e.g. the compile time)
+#define WWVB_QUALITY_DEGRADED 1 // restored after a reset, not re-synced yet
+#define WWVB_QUALITY_SYNCED 2   // set from a good time source (e.g. gps)
+
+#define WWVB_STATE_RECORD_SIZE 12
+
+struct wwvb_eeprom
+{
+	uint8_t (*read)(const uint16_t &_address);
+	void (*write)(const uint16_t &_address, const uint8_t &_value);
+};
+
+// _minutes : minutes since 00:00 1 Jan 2000 UTC, read returns false if the rtc has lost the time
+struct wwvb_rtc
+{
+	bool (*read)(uint32_t &_minutes, uint8_t &_secs);
+	void (*write)(const uint32_t &_minutes, const uint8_t &_secs);
+};
+
+#if defined(__AVR__)
+#include <avr/eeprom.h>
+
+inline uint8_t wwvb_eeprom_avr_read(const uint16_t &_address)
+{
+	return eeprom_read_byte((uint8_t *)_address);
+}
+inline void wwvb_eeprom_avr_write(const uint16_t &_address, const uint8_t &_value)
+{
+	eeprom_update_byte((uint8_t *)_address, _value);
+}
+const wwvb_eeprom wwvb_eeprom_avr = { wwvb_eeprom_avr_read, wwvb_eeprom_avr_write };
+#define WWVB_EEPROM_DEFAULT wwvb_eeprom_avr
+#endif
+
+#if !defined(__AVR__)
+// Simulated EEPROM (1kB, erased to 0xFF) with a write count per byte
+struct wwvb_eeprom_sim
+{
+	uint8_t data[1024];
+	uint32_t writes[1024];
+};
+inline wwvb_eeprom_sim &wwvb_eeprom_sim_state()
+{
+	static wwvb_eeprom_sim _sim = { { 0 }, { 0 } };
+	static bool _is_erased = false;
+	if (!_is_erased)
+	{
+		for (uint16_t i = 0; i < 1024; ++i) { _sim.data[i] = 0xFF; }
+		_is_erased = true;
+	}
+	return _sim;
+}
+inline uint8_t wwvb_eeprom_sim_read(const uint16_t &_address)
+{
+	return wwvb_eeprom_sim_state().data[_address & 0x3FF];
+}
+inline void wwvb_eeprom_sim_write(const uint16_t &_address, const uint8_t &_value)
+{
+	wwvb_eeprom_sim &_sim = wwvb_eeprom_sim_state();
+	if (_sim.data[_address & 0x3FF] != _value) // like eeprom_update_byte
+	{
+		_sim.data[_address & 0x3FF] = _value;
+		++_sim.writes[_address & 0x3FF];
+	}
+}
+const wwvb_eeprom wwvb_eeprom_simulated = { wwvb_eeprom_sim_read, wwvb_eeprom_sim_write };
+#define WWVB_EEPROM_DEFAULT wwvb_eeprom_simulated
+
+// Simulated RTC : advance it with wwvb_rtc_sim_state().minutes etc., or clear running to lose the time
+struct wwvb_rtc_sim
+{
+	uint32_t minutes;
+	uint8_t secs;
+	bool running;
+};
+inline wwvb_rtc_sim &wwvb_rtc_sim_state()
+{
+	static wwvb_rtc_sim _sim = { 0, 0, false };
+	return _sim;
+}
+inline bool wwvb_rtc_sim_read(uint32_t &_minutes, uint8_t &_secs)
+{
+	_minutes = wwvb_rtc_sim_state().minutes;
+	_secs = wwvb_rtc_sim_state().secs;
+	return wwvb_rtc_sim_state().running;
+}
+inline void wwvb_rtc_sim_write(const uint32_t &_minutes, const uint8_t &_secs)
+{
+	wwvb_rtc_sim_state().minutes = _minutes;
+	wwvb_rtc_sim_state().secs = _secs;
+	wwvb_rtc_sim_state().running = true;
+}
+const wwvb_rtc wwvb_rtc_simulated = { wwvb_rtc_sim_read, wwvb_rtc_sim_write };
+#endif
+
+inline uint8_t wwvb_crc8(const uint8_t *_data, const uint8_t &_n)
+{
+	uint8_t _crc = 0xFF;
+	for (uint8_t i = 0; i < _n; ++i)
+	{
+		_crc ^= _data[i];
+		for (uint8_t b = 0; b < 8; ++b)
+		{
+			_crc = (_crc & 0x80) ? (_crc << 1) ^ 0x07 : (_crc << 1);
+		}
+	}
+	return _crc;
+}
+
+class wwvb_state
+{
+private:
+	wwvb_eeprom eeprom_;
+	const wwvb_rtc *rtc_;
+	uint16_t address_;
+	uint8_t slots_;
+	uint8_t slot_;    // slot of the next write
+	uint8_t seq_;     // seq of the next write
+	bool is_scanned_; // slot_ and seq_ have been found from the records
+	uint8_t quality_;
+	uint8_t secs_;    // second of the restored minute
+
+	// read slot _slot into _record, returns false if its crc doesnt match
+	bool read_record(const uint8_t &_slot, uint8_t *_record)
+	{
+		const uint16_t _address = address_ + (uint16_t)_slot * WWVB_STATE_RECORD_SIZE;
+		for (uint8_t i = 0; i < WWVB_STATE_RECORD_SIZE; ++i)
+		{
+			_record[i] = eeprom_.read(_address + i);
+		}
+		return wwvb_crc8(_record, WWVB_STATE_RECORD_SIZE - 1) == _record[WWVB_STATE_RECORD_SIZE - 1];
+	}
+
+	// newest valid record, returns false if there isnt one
+	bool find_record(uint8_t *_record)
+	{
+		uint8_t _buffer[WWVB_STATE_RECORD_SIZE];
+		uint8_t _seq = 0;
+		bool _found = false;
+		is_scanned_ = true;
+		for (uint8_t s = 0; s < slots_; ++s)
+		{
+			if (!read_record(s, _buffer))
+			{
+				continue;
+			}
+			if (!_found || ((int8_t)(_buffer[0] - _seq) > 0))
+			{
+				_seq = _buffer[0];
+				for (uint8_t i = 0; i < WWVB_STATE_RECORD_SIZE; ++i) { _record[i] = _buffer[i]; }
+				slot_ = (s + 1) % slots_;
+				seq_ = _buffer[0] + 1;
+				_found = true;
+			}
+		}
+		return _found;
+	}
+
+	static uint32_t utc_minutes(wwvb &_tx)
+	{
+		volatile uint8_t _hour, _mins, _DD, _MM, _YY;
+		_tx.get_time(_hour, _mins, _DD, _MM, _YY);
+		const uint8_t _YY_ = _YY, _hour_ = _hour, _mins_ = _mins;
+		const uint16_t _doty = to_day_of_the_year<volatile uint8_t>(_DD, _MM, is_leap_year(2000 + _YY_));
+		return wwvb_pm_minute_of_century(_hour_, _mins_, _doty, _YY_);
+	}
+
+public:
+	// _slots records (WWVB_STATE_RECORD_SIZE bytes each) from EEPROM address _address
+	wwvb_state(const uint16_t &_address = 0, const uint8_t &_slots = 32, const wwvb_eeprom &_eeprom = WWVB_EEPROM_DEFAULT)
+		: eeprom_(_eeprom), rtc_(0), address_(_address), slots_(_slots), slot_(0), seq_(0), is_scanned_(false),
+		quality_(WWVB_QUALITY_NONE), secs_(0)
+	{
+	}
+
+	// use an rtc to restore the time (0 : no rtc), the rtc is written by synced()
+	void setRTC(const wwvb_rtc *_rtc)
+	{
+		rtc_ = _rtc;
+	}
+
+	uint8_t quality()
+	{
+		return quality_;
+	}
+
+	// Restore the wwvb state after a reset, call it after setTimezone(), then start(secs())
+	// The time is read from the rtc if it is running, otherwise it is estimated as the minute after the last checkpoint
+	// (up to one checkpoint interval stale, plus the time spent in reset).
+	// Returns false (and leaves _tx alone) if there is neither
+	bool restore(wwvb &_tx)
+	{
+		uint8_t _record[WWVB_STATE_RECORD_SIZE];
+		const bool _has_record = find_record(_record);
+
+		uint32_t _minutes;
+		uint8_t _secs = 0;
+		if ((rtc_ != 0) && rtc_->read(_minutes, _secs))
+		{
+			_secs = (_secs < 60) ? _secs : 59;
+		}
+		else if (_has_record)
+		{
+			_secs = 0;
+			_minutes = ((uint32_t)_record[1] | ((uint32_t)_record[2] << 8) | ((uint32_t)_record[3] << 16) | ((uint32_t)_record[4] << 24)) + 1;
+		}
+		else
+		{
+			return false;
+		}
+
+		uint8_t _dst_mode = WWVB_DST_NO;
+		if (_has_record)
+		{
+			_tx.calibrate((int16_t)(_record[5] | (_record[6] << 8)), (int16_t)(_record[7] | (_record[8] << 8)));
+			_dst_mode = _record[9];
+		}
+
+		// set_time adds the timezone, so take it off the utc time
+		int8_t _tz_HH, _tz_MM;
+		_tx.getTimezone(_tz_HH, _tz_MM);
+		_minutes -= (int32_t)_tz_HH * 60 + _tz_MM;
+
+		uint8_t _hour, _mins, _YY, _DD, _MM;
+		uint16_t _doty;
+		wwvb_pm_from_minute_of_century(_minutes, _hour, _mins, _doty, _YY);
+		from_day_of_the_year<uint8_t>(_doty, _DD, _MM, is_leap_year(2000 + _YY));
+		_tx.set_time(_hour, _mins, _DD, _MM, _YY, _dst_mode);
+
+		secs_ = _secs;
+		quality_ = WWVB_QUALITY_DEGRADED;
+		return true;
+	}
+
+	// second of the restored minute to start() at (0 if the time came from the last checkpoint)
+	uint8_t secs()
+	{
+		return secs_;
+	}
+
+	// Checkpoint the wwvb state (e.g. every 10 minutes, at the start of a frame)
+	void save(wwvb &_tx)
+	{
+		uint8_t _record[WWVB_STATE_RECORD_SIZE];
+		if (!is_scanned_)
+		{
+			find_record(_record); // carry on from the newest record
+		}
+		const uint32_t _minutes = utc_minutes(_tx);
+		int16_t _c0, _c1;
+		_tx.getCalibration(_c0, _c1);
+
+		_record[0] = seq_;
+		for (uint8_t i = 0; i < 4; ++i) { _record[1 + i] = (_minutes >> (8 * i)) & 0xFF; }
+		_record[5] = _c0 & 0xFF;
+		_record[6] = (_c0 >> 8) & 0xFF;
+		_record[7] = _c1 & 0xFF;
+		_record[8] = (_c1 >> 8) & 0xFF;
+		_record[9] = _tx.getDSTMode();
+		_record[10] = quality_;
+		_record[11] = wwvb_crc8(_record, WWVB_STATE_RECORD_SIZE - 1);
+
+		const uint16_t _address = address_ + (uint16_t)slot_ * WWVB_STATE_RECORD_SIZE;
+		for (uint8_t i = 0; i < WWVB_STATE_RECORD_SIZE; ++i)
+		{
+			eeprom_.write(_address + i, _record[i]);
+		}
+		slot_ = (slot_ + 1) % slots_;
+		++seq_;
+	}
+
+	// The wwvb time has been set from a good time source : mark it synced, set the rtc and checkpoint it
+	void synced(wwvb &_tx)
+	{
+		quality_ = WWVB_QUALITY_SYNCED;
+		if (rtc_ != 0)
+		{
+			rtc_->write(utc_minutes(_tx), _tx.ss());
+		}
+		save(_tx);
+	}
+};
+
+#endif
@@ -0,0 +1,302 @@
+#ifndef wwvb_telemetry_h
+#define wwvb_telemetry_h
+
+/*
+Deferred binary telemetry
+
+With WWVB_TELEMETRY defined, wwvb::raw() and wwvb::debug_time() dont print - they add a compact
+record to a ring buffer, which is sent a few bytes at a time from loop() without blocking:
+
+wwvb_tx.debug_time();              // ~16 bytes into the buffer, instead of ~400 characters at 9600 baud
+...
+wwvb_tx.telemetry.service(Serial); // in loop() : only writes what fits in the serial tx buffer
+
+The host decoder (wwvb_telemetry_decoder, host only) turns the byte stream back into the
+text that raw() and debug_time() print.
+
+record | bytes
+-------+---------------------------------------------------------------
+all    | 0xA5, type, payload, checksum (the 8 bit sum of type and payload, negated)
+RAW    | payload : frame (8 bytes, little endian, see wwvb::frame)
+STATE  | payload : hour, mins, DD, MM, YY (the internal time), frame (8 bytes)
+
+If the buffer is full the record is dropped (and counted, see dropped()), records are never split.
+The time and frame of a record are copied with a sequence counter (see wwvb::snapshot), so a record made
+in loop() while the isr changes the minute is all of one minute or all of the next, never a mix.
+
+Copyright (c) 2015 Mark Cooke, Martin Sniedze
+
+Author/s: [Mark Cooke](https://www.github.com/micooke), [Martin Sniedze](https://www.github.com/mr-sneezy)
+
+License: MIT license (see LICENSE file).
+*/
+
+#include <stdint.h>
+
+// buffer size in bytes, a power of 2 up to 128
+#if !defined(WWVB_TELEMETRY_SIZE)
+#define WWVB_TELEMETRY_SIZE 64
+#endif
+
+#define WWVB_TLM_SYNC 0xA5
+#define WWVB_TLM_RAW 1
+#define WWVB_TLM_STATE 2
+
+// payload bytes of each record type
+#define WWVB_TLM_RAW_SIZE 8
+#define WWVB_TLM_STATE_SIZE 13
+
+inline void wwvb_telemetry_pack_frame(uint8_t *_bytes, const uint64_t &_frame)
+{
+	for (uint8_t i = 0; i < 8; ++i)
+	{
+		_bytes[i] = (_frame >> (8 * i)) & 0xFF;
+	}
+}
+
+inline uint64_t wwvb_telemetry_unpack_frame(const uint8_t *_bytes)
+{
+	uint64_t _frame = 0;
+	for (uint8_t i = 8; i-- > 0;)
+	{
+		_frame = (_frame << 8) | _bytes[i];
+	}
+	return _frame;
+}
+
+class wwvb_telemetry
+{
+private:
+	uint8_t buffer_[WWVB_TELEMETRY_SIZE];
+	volatile uint8_t head_; // next byte to write
+	volatile uint8_t tail_; // next byte to send
+	uint8_t dropped_;
+
+	void put(const uint8_t &_byte)
+	{
+		buffer_[head_] = _byte;
+		head_ = (head_ + 1) & (WWVB_TELEMETRY_SIZE - 1);
+	}
+
+public:
+	wwvb_telemetry() : head_(0), tail_(0), dropped_(0) {}
+
+	// bytes waiting to be sent
+	uint8_t available()
+	{
+		return (head_ - tail_) & (WWVB_TELEMETRY_SIZE - 1);
+	}
+
+	// records dropped because the buffer was full
+	uint8_t dropped()
+	{
+		return dropped_;
+	}
+
+	// add a record, returns false (and counts a drop) if it doesnt fit
+	bool record(const uint8_t &_type, const uint8_t *_payload, const uint8_t &_n)
+	{
+		if ((uint16_t)available() + _n + 3 > WWVB_TELEMETRY_SIZE - 1)
+		{
+			if (dropped_ < 0xFF) { ++dropped_; }
+			return false;
+		}
+		uint8_t _sum = _type;
+		put(WWVB_TLM_SYNC);
+		put(_type);
+		for (uint8_t i = 0; i < _n; ++i)
+		{
+			put(_payload[i]);
+			_sum += _payload[i];
+		}
+		put(-_sum);
+		return true;
+	}
+
+	// next byte to send (check available() first)
+	uint8_t read()
+	{
+		const uint8_t _byte = buffer_[tail_];
+		tail_ = (tail_ + 1) & (WWVB_TELEMETRY_SIZE - 1);
+		return _byte;
+	}
+
+	// Send as many bytes as _out can take without blocking (e.g. Serial), call it from loop()
+	template <typename STREAM>
+	void service(STREAM &_out)
+	{
+		int _space = _out.availableForWrite();
+		while ((_space-- > 0) && available())
+		{
+			_out.write(read());
+		}
+	}
+};
+
+#if !defined(__AVR__)
+#include <stdio.h>
+#include <string>
+
+// Host decoder : feed it the telemetry byte stream, each record is rendered as the text
+// raw() / debug_time() would have printed
+class wwvb_telemetry_decoder
+{
+private:
+	uint8_t record_[2 + WWVB_TLM_STATE_SIZE + 1];
+	uint8_t length_;
+	uint32_t errors_;
+
+	static uint8_t payload_size(const uint8_t &_type)
+	{
+		switch (_type)
+		{
+		case WWVB_TLM_RAW:
+			return WWVB_TLM_RAW_SIZE;
+		case WWVB_TLM_STATE:
+			return WWVB_TLM_STATE_SIZE;
+		}
+		return 0xFF;
+	}
+
+	static uint8_t bit(const uint64_t &_frame, const uint8_t &_index)
+	{
+		return (_frame >> _index) & 0x01;
+	}
+
+	// see print_datetime (TimeDateTools.h)
+	static void datetime(std::string &_text, const uint8_t &_hour, const uint8_t &_mins,
+		const uint8_t &_DD, const uint8_t &_MM, const uint8_t &_YY)
+	{
+		char _line[32];
+		snprintf(_line, sizeof(_line), "%02u:%02u on %02u/%02u/20%02u\n", _hour, _mins, _DD, _MM, _YY);
+		_text += _line;
+	}
+
+public:
+	wwvb_telemetry_decoder() : length_(0), errors_(0) {}
+
+	// records with a bad checksum or type
+	uint32_t errors() { return errors_; }
+
+	// see wwvb::raw
+	static std::string raw(const uint64_t &_frame)
+	{
+		static const char *_name[6] = { "MINS", "HOUR", "DOTY", "DUT1", "YEAR", "MISC" };
+		std::string _text = "INDX: [0 1 2 3 4 5 6 7 8 9]\n";
+		for (uint8_t s = 0; s < 6; ++s)
+		{
+			_text += _name[s];
+			_text += ": [";
+			for (uint8_t i = 0; i < 10; ++i)
+			{
+				const uint8_t _index = 10 * s + i;
+				if ((_index == 0) | (i == 9))
+				{
+					_text += (i == 9) ? "M]\n" : "M ";
+				}
+				else
+				{
+					_text += (char)('0' + bit(_frame, _index));
+					_text += ' ';
+				}
+			}
+		}
+		_text += "\n";
+		return _text;
+	}
+
+	// see wwvb::debug_time
+	static std::string state(const uint8_t *_payload)
+	{
+		const uint64_t _frame = wwvb_telemetry_unpack_frame(_payload + 5);
+		std::string _text = "internal state\n";
+		datetime(_text, _payload[0], _payload[1], _payload[2], _payload[3], _payload[4]);
+		_text += "raw bits\n";
+		_text += raw(_frame);
+		_text += "decoded state\n";
+
+		// see wwvb::get_mins etc.
+		const uint8_t _mins = bit(_frame, 1) * 40 + bit(_frame, 2) * 20 + bit(_frame, 3) * 10
+			+ bit(_frame, 5) * 8 + bit(_frame, 6) * 4 + bit(_frame, 7) * 2 + bit(_frame, 8);
+		const uint8_t _hour = bit(_frame, 12) * 20 + bit(_frame, 13) * 10
+			+ bit(_frame, 15) * 8 + bit(_frame, 16) * 4 + bit(_frame, 17) * 2 + bit(_frame, 18);
+		uint16_t _doty = bit(_frame, 22) * 200 + bit(_frame, 23) * 100
+			+ bit(_frame, 25) * 80 + bit(_frame, 26) * 40 + bit(_frame, 27) * 20 + bit(_frame, 28) * 10
+			+ bit(_frame, 30) * 8 + bit(_frame, 31) * 4 + bit(_frame, 32) * 2 + bit(_frame, 33);
+		const uint8_t _YY = bit(_frame, 45) * 80 + bit(_frame, 46) * 40 + bit(_frame, 47) * 20 + bit(_frame, 48) * 10
+			+ bit(_frame, 50) * 8 + bit(_frame, 51) * 4 + bit(_frame, 52) * 2 + bit(_frame, 53);
+		const uint8_t _dut1 = bit(_frame, 40) * 8 + bit(_frame, 41) * 4 + bit(_frame, 42) * 2 + bit(_frame, 43);
+		const bool _is_ly = bit(_frame, 55);
+		const bool _is_ls = bit(_frame, 56);
+		const uint8_t _ds = (bit(_frame, 57) << 1) | bit(_frame, 58);
+
+		// see from_day_of_the_year (TimeDateTools.h)
+		static const uint8_t _month_days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+		uint8_t _MM = 1;
+		while ((_MM < 12) && (_doty > _month_days[_MM - 1] + ((_MM == 2) & _is_ly)))
+		{
+			_doty -= _month_days[_MM - 1] + ((_MM == 2) & _is_ly);
+			++_MM;
+		}
+		datetime(_text, _hour, _mins, (uint8_t)_doty, _MM, _YY);
+
+		_text += "dut1 = ";
+		if (bit(_frame, 37) | (bit(_frame, 36) & bit(_frame, 38)))
+		{
+			_text += (bit(_frame, 37) & (_dut1 > 0)) ? "-0." : "+0."; // -0 is printed as +0.0
+			_text += (char)('0' + _dut1);
+		}
+		else { _text += "error"; }
+		_text += "\nleap year = ";
+		_text += _is_ly ? "true" : "false";
+		_text += "\nleap second = ";
+		_text += _is_ls ? "true" : "false";
+		_text += "\ndaylight savings time ";
+		static const char *_dst[4] = { "is not in effect", "ends today", "begins today", "is in effect" };
+		_text += _dst[_ds];
+		_text += "\n";
+		return _text;
+	}
+
+	// add a byte, returns true (and sets _text) when a record is complete
+	bool decode(const uint8_t &_byte, std::string &_text)
+	{
+		if ((length_ == 0) & (_byte != WWVB_TLM_SYNC))
+		{
+			return false; // resync
+		}
+		record_[length_++] = _byte;
+		if (length_ < 2)
+		{
+			return false;
+		}
+		const uint8_t _n = payload_size(record_[1]);
+		if (_n == 0xFF)
+		{
+			++errors_;
+			length_ = 0;
+			return false;
+		}
+		if (length_ < _n + 3)
+		{
+			return false;
+		}
+		length_ = 0;
+
+		uint8_t _sum = 0;
+		for (uint8_t i = 1; i < _n + 3; ++i)
+		{
+			_sum += record_[i];
+		}
+		if (_sum != 0)
+		{
+			++errors_;
+			return false;
+		}
+		_text = (record_[1] == WWVB_TLM_RAW) ? raw(wwvb_telemetry_unpack_frame(record_ + 2)) : state(record_ + 2);
+		return true;
+	}
+};
+#endif
+
+#endif